@@ -0,0 +1,154 @@
+#!/bin/sh
+# author: Bonino, Francisco Ignacio.
+# version: 1.0
+# since: 2026-10-17
+#
+# Benchmarks de la shell. Se ejecuta con 'make bench' desde la raíz del
+# proyecto, y los resultados se escriben en stdout como un objeto JSON
+# para poder comparar distintas versiones.
+# Cada caso se ejecuta con bin/myshell de manera no interactiva (con un
+# script generado) y, cuando tiene sentido, con dash (o /bin/sh) como
+# referencia.
+#
+# Variables de entorno opcionales:
+#   BENCH_LINES  Cantidad de líneas de los scripts de comandos (2000).
+#   BENCH_MB     Tamaño en MB de los datos para pipes y redirecciones (64).
+#   BENCH_RUNS   Cantidad de arranques para medir el startup (200).
+
+set -eu
+
+SHELL_BIN=./bin/myshell
+LINES=${BENCH_LINES:-2000}
+MB=${BENCH_MB:-64}
+RUNS=${BENCH_RUNS:-200}
+
+if command -v dash > /dev/null 2>&1; then
+    BASE=$(command -v dash)
+else
+    BASE=/bin/sh
+fi
+
+if [ ! -x "$SHELL_BIN" ]; then
+    echo "bench: $SHELL_BIN not found, run 'make' first" >&2
+    exit 1
+fi
+
+TMP=$(mktemp -d)
+IN=$TMP/data_in
+OUT=$TMP/data_out
+
+trap 'rm -rf "$TMP"' EXIT INT TERM
+
+head -c "$((MB * 1048576))" /dev/zero > "$IN"
+
+now_ns() {
+    date +%s%N
+}
+
+# Ejecuta un comando y escribe en stdout los nanosegundos que tardó.
+elapsed() {
+    t0=$(now_ns)
+    "$@" > /dev/null
+    t1=$(now_ns)
+    echo $((t1 - t0))
+}
+
+# Genera un script con LINES copias de una línea.
+mk_script() {
+    awk -v n="$LINES" -v line="$2" 'BEGIN { for (i = 0; i < n; i++) print line }' > "$1"
+}
+
+# Arranca RUNS veces una shell con un comando trivial.
+startup() {
+    i=0
+
+    while [ "$i" -lt "$RUNS" ]; do
+        "$1" -c true
+        i=$((i + 1))
+    done
+}
+
+# Escribe un resultado: nombre, unidad, valor de la shell y de la referencia.
+result() {
+    printf '%s    {"name": "%s", "unit": "%s", "myshell": %s, "baseline": %s}' "$SEP" "$1" "$2" "$3" "$4"
+    SEP=",
+"
+}
+
+rate() {
+    awk -v n="$1" -v ns="$2" 'BEGIN { printf "%.1f", n / (ns / 1e9) }'
+}
+
+per_run_us() {
+    awk -v n="$1" -v ns="$2" 'BEGIN { printf "%.1f", ns / n / 1e3 }'
+}
+
+SEP=""
+
+printf '{\n  "shell": "%s",\n  "baseline": "%s",\n  "date": "%s",\n' "$SHELL_BIN" "$BASE" "$(date -u +%Y-%m-%dT%H:%M:%SZ)"
+printf '  "lines": %s,\n  "data_mb": %s,\n  "results": [\n' "$LINES" "$MB"
+
+# Tiempo de arranque
+ns=$(elapsed startup "$SHELL_BIN")
+base=$(elapsed startup "$BASE")
+result "startup" "us/run" "$(per_run_us "$RUNS" "$ns")" "$(per_run_us "$RUNS" "$base")"
+
+# Lanzamiento de un programa externo trivial
+mk_script "$TMP/launch.sh" "/bin/true"
+ns=$(elapsed "$SHELL_BIN" "$TMP/launch.sh")
+base=$(elapsed "$BASE" "$TMP/launch.sh")
+result "launch" "cmds/s" "$(rate "$LINES" "$ns")" "$(rate "$LINES" "$base")"
+
+# Comando interno 'echo'
+mk_script "$TMP/echo.sh" "echo hello world"
+ns=$(elapsed "$SHELL_BIN" "$TMP/echo.sh")
+base=$(elapsed "$BASE" "$TMP/echo.sh")
+result "echo" "cmds/s" "$(rate "$LINES" "$ns")" "$(rate "$LINES" "$base")"
+
+# Pipelines de 2, 4 y 8 etapas: cat < datos | cat | ... | wc -c
+for stages in 2 4 8; do
+    mid=""
+    i=2
+
+    while [ "$i" -lt "$stages" ]; do
+        mid="$mid | cat"
+        i=$((i + 1))
+    done
+
+    echo "cat < $IN$mid | wc -c" > "$TMP/pipe.sh"
+
+    ns=$(elapsed "$SHELL_BIN" "$TMP/pipe.sh")
+    base=$(elapsed "$BASE" "$TMP/pipe.sh")
+    result "pipeline_$stages" "MB/s" "$(rate "$MB" "$ns")" "$(rate "$MB" "$base")"
+done
+
+# Pipeline de 4 etapas con pipes de 1 MiB (sólo en la shell, dash no tiene 'pipesize')
+echo "pipesize 1M cat < $IN | cat | cat | wc -c" > "$TMP/pipe.sh"
+ns=$(elapsed "$SHELL_BIN" "$TMP/pipe.sh")
+result "pipeline_4_1m" "MB/s" "$(rate "$MB" "$ns")" "null"
+
+# Bifurcación de un stream hacia un archivo y otra etapa (en dash, /usr/bin/tee)
+echo "cat < $IN | tee $OUT | wc -c" > "$TMP/tee.sh"
+ns=$(elapsed "$SHELL_BIN" "$TMP/tee.sh")
+base=$(elapsed "$BASE" "$TMP/tee.sh")
+result "tee" "MB/s" "$(rate "$MB" "$ns")" "$(rate "$MB" "$base")"
+
+# Redirecciones de un programa externo y del comando interno 'echo'
+echo "cat < $IN > $OUT" > "$TMP/redir.sh"
+ns=$(elapsed "$SHELL_BIN" "$TMP/redir.sh")
+base=$(elapsed "$BASE" "$TMP/redir.sh")
+result "redirect_cat" "MB/s" "$(rate "$MB" "$ns")" "$(rate "$MB" "$base")"
+
+# Agregado al final de un log: cada ejecución escribe después de la anterior
+echo "cat < $IN >> $OUT" > "$TMP/append.sh"
+: > "$OUT"
+ns=$(elapsed "$SHELL_BIN" "$TMP/append.sh")
+: > "$OUT"
+base=$(elapsed "$BASE" "$TMP/append.sh")
+result "redirect_append" "MB/s" "$(rate "$MB" "$ns")" "$(rate "$MB" "$base")"
+
+echo "echo < $IN > $OUT" > "$TMP/redir.sh"
+ns=$(elapsed "$SHELL_BIN" "$TMP/redir.sh")
+result "redirect_echo" "MB/s" "$(rate "$MB" "$ns")" "null"
+
+printf '\n  ]\n}\n'
@@ -0,0 +1,143 @@
+/**
+ * @file arena.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con un asignador de memoria por regiones
+ *        (arena) para los datos de cada comando.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/arena.h"
+
+/**
+ * @brief Esta función agrega a la arena un bloque nuevo con
+ *        lugar para al menos la cantidad de bytes indicada.
+ *
+ * @param a Arena a la que se agrega el bloque.
+ * @param size Cantidad mínima de bytes del bloque.
+ */
+static void arena_grow(arena *a, size_t size)
+{
+    size_t cap = (size > _ARENA_BLOCK_LEN_) ? size : _ARENA_BLOCK_LEN_;
+
+    arena_block *block = (arena_block *)malloc(sizeof(arena_block) + cap);
+
+    if (!block)
+        show_err("Could not allocate memory for command arena", _FATAL_ERR_);
+
+    block->next = a->head;
+    block->cap = cap;
+    block->used = 0;
+
+    a->head = block;
+}
+
+/**
+ * @brief Esta función libera toda la memoria de una arena.
+ *
+ * @param a Arena a liberar.
+ */
+void arena_free(arena *a)
+{
+    while (a->head)
+    {
+        arena_block *next = a->head->next;
+
+        free(a->head);
+
+        a->head = next;
+    }
+}
+
+/**
+ * @brief Esta función devuelve de una sola vez toda la memoria
+ *        entregada por la arena, para reutilizarla.
+ *
+ * @details Si la arena tuvo que crecer, se reemplazan todos sus
+ *          bloques por uno solo con la capacidad total, de modo
+ *          que las próximas líneas de tamaño similar no necesiten
+ *          ninguna llamada a 'malloc'.
+ *
+ * @param a Arena a reiniciar.
+ */
+void arena_reset(arena *a)
+{
+    if (!a->head)
+        return;
+
+    if (!a->head->next)
+    {
+        a->head->used = 0;
+
+        return;
+    }
+
+    size_t total = 0;
+
+    for (arena_block *block = a->head; block; block = block->next)
+        total += block->cap;
+
+    arena_free(a);
+    arena_grow(a, total);
+}
+
+/**
+ * @brief Esta función reserva memoria de una arena.
+ *
+ * @details La memoria devuelta está alineada para cualquier tipo
+ *          y sólo es válida hasta el próximo arena_reset. No debe
+ *          liberarse con 'free'.
+ *
+ * @param a Arena de la que se reserva la memoria.
+ * @param size Cantidad de bytes a reservar.
+ *
+ * @returns La memoria reservada.
+ */
+void *arena_alloc(arena *a, size_t size)
+{
+    // Redondeamos para que el próximo bloque entregado quede alineado
+    size = (size + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+
+    if (!a->head || (a->head->cap - a->head->used < size))
+        arena_grow(a, size);
+
+    void *mem = (char *)a->head->data + a->head->used;
+
+    a->head->used += size;
+
+    return mem;
+}
+
+/**
+ * @brief Esta función reserva memoria inicializada con ceros
+ *        de una arena.
+ *
+ * @param a Arena de la que se reserva la memoria.
+ * @param amount Cantidad de elementos.
+ * @param size Tamaño de cada elemento.
+ *
+ * @returns La memoria reservada.
+ */
+void *arena_calloc(arena *a, size_t amount, size_t size)
+{
+    void *mem = arena_alloc(a, amount * size);
+
+    memset(mem, 0, amount * size);
+
+    return mem;
+}
+
+/**
+ * @brief Esta función copia un string en una arena.
+ *
+ * @param a Arena de la que se reserva la memoria.
+ * @param str String a copiar.
+ *
+ * @returns La copia del string.
+ */
+char *arena_strdup(arena *a, char *str)
+{
+    size_t len = strlen(str) + 1;
+
+    return (char *)memcpy(arena_alloc(a, len), str, len);
+}
@@ -0,0 +1,999 @@
+/**
+ * @file batch.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con la ejecución de las líneas de los
+ *        batchfiles, en serie o en paralelo.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/batch.h"
+
+static worker *workers = NULL; // Líneas en ejecución en la sección paralela
+
+static int workers_cap = 0;
+static int running = 0;
+static int width = 0; // Máximo de líneas en ejecución a la vez
+static int section_status = EXIT_SUCCESS;
+
+static bool in_block = false; // Si se está dentro de un bloque 'parallel { ... }'
+
+static char *script = NULL; // Batchfile compilado en ejecución
+
+/**
+ * @brief Esta función indica si una línea es una palabra clave de
+ *        los batchfiles, sin importar los espacios entre sus partes.
+ *
+ * @param line Línea a analizar (sin espacios al comienzo ni al final).
+ * @param word Palabra clave.
+ * @param suffix Parte que debe seguir a la palabra clave, o "".
+ *
+ * @returns Si la línea es la palabra clave.
+ */
+static bool is_keyword(char *line, char *word, char *suffix)
+{
+    size_t len = strlen(word);
+
+    if (strncmp(line, word, len) != 0)
+        return false;
+
+    line += len;
+
+    if ((*suffix != '\0') && (line[0] != ' ') && (line[0] != '\t') && (line[0] != *suffix))
+        return false;
+
+    while ((*line == ' ') || (*line == '\t'))
+        line++;
+
+    return strcmp(line, suffix) == 0;
+}
+
+/**
+ * @brief Esta función indica si una línea es alguna de las palabras
+ *        clave de los batchfiles o de las estructuras de control (al
+ *        compilar no hay estructuras abiertas).
+ *
+ * @param line Línea a analizar (sin espacios al comienzo ni al final).
+ *
+ * @returns Si la línea es una palabra clave.
+ */
+static bool batch_keyword(char *line)
+{
+    return is_keyword(line, "parallel", "{") || (strcmp(line, "}") == 0) ||
+           (strcmp(line, "barrier") == 0) || (strcmp(line, "quit") == 0) || ctl_takes(line);
+}
+
+/**
+ * @brief Esta función agrega datos al final de un batchfile compilado.
+ *
+ * @details Los datos se alinean a 8 bytes, para que cualquier estructura
+ *          pueda leerse directamente desde el archivo mapeado.
+ *
+ * @param b Batchfile compilado.
+ * @param data Datos a agregar, o NULL para reservar el lugar en cero.
+ * @param len Largo de los datos.
+ *
+ * @returns El offset de los datos, o 0 si no entran en el archivo.
+ */
+static uint32_t shc_put(shc_buf *b, const void *data, size_t len)
+{
+    size_t off = (b->len + 7) & ~(size_t)7;
+
+    if (off + len > UINT32_MAX)
+    {
+        b->full = true;
+
+        return 0;
+    }
+
+    if (off + len > b->cap)
+    {
+        size_t cap = b->cap ? b->cap : _ARENA_BLOCK_LEN_;
+
+        while (cap < off + len)
+            cap *= 2;
+
+        char *aux = (char *)realloc(b->data, cap);
+
+        if (!aux)
+            show_err("Could not allocate memory for compiled batchfile", _FATAL_ERR_);
+
+        b->data = aux;
+        b->cap = cap;
+    }
+
+    memset(b->data + b->len, 0, off - b->len);
+
+    if (data)
+        memcpy(b->data + off, data, len);
+    else
+        memset(b->data + off, 0, len);
+
+    b->len = off + len;
+
+    return (uint32_t)off;
+}
+
+/**
+ * @brief Esta función agrega un string al final de un batchfile compilado.
+ *
+ * @param b Batchfile compilado.
+ * @param str String a agregar.
+ *
+ * @returns El offset del string.
+ */
+static uint32_t shc_str(shc_buf *b, char *str)
+{
+    return shc_put(b, str, strlen(str) + 1);
+}
+
+/**
+ * @brief Esta función compila una línea de un batchfile.
+ *
+ * @details Se guardan las etapas ya analizadas (con sus palabras sin
+ *          expandir y sus redirecciones) y el path de cada programa
+ *          externo que puede resolverse de antemano. Las palabras clave
+ *          y las líneas con errores de sintaxis se guardan sin analizar,
+ *          para procesarlas (e informar los errores) al ejecutarlas.
+ *
+ * @param b Batchfile compilado.
+ * @param line Línea a compilar (sin espacios al comienzo ni al final).
+ *
+ * @returns El offset de la línea compilada, o 0 si no hay nada que
+ *          ejecutar (sólo comentarios).
+ */
+static uint32_t shc_compile_line(shc_buf *b, char *line)
+{
+    char *err;
+
+    pipeline *pl = batch_keyword(line) ? NULL : parse_line(&cmd_arena, line, &err);
+
+    if (pl && (pl->cmds_amount == 0))
+    {
+        arena_reset(&cmd_arena);
+
+        return 0;
+    }
+
+    shc_line rec = { 0 };
+
+    uint32_t rec_off = shc_put(b, NULL, sizeof(shc_line));
+
+    rec.text = shc_str(b, line);
+
+    if (pl)
+    {
+        rec.cmds = shc_put(b, NULL, pl->cmds_amount * sizeof(shc_cmd));
+        rec.cmds_amount = pl->cmds_amount;
+        rec.bg = pl->bg;
+        rec.timed = pl->timed;
+        rec.cpus_list = pl->cpus_list;
+        rec.spread = pl->spread;
+        rec.pipe_size = pl->pipe_size ? shc_str(b, pl->pipe_size) : 0;
+        rec.cpus = pl->cpus ? shc_str(b, pl->cpus) : 0;
+        rec.niceness = pl->niceness ? shc_str(b, pl->niceness) : 0;
+        rec.limits = pl->limits ? shc_str(b, pl->limits) : 0;
+
+        for (int i = 0; (i < pl->cmds_amount) && !b->full; i++)
+        {
+            command *cmd = &pl->cmds[i];
+
+            shc_cmd sc = { 0 };
+
+            sc.argc = cmd->argc;
+            sc.builtin = cmd->builtin;
+            sc.argv = shc_put(b, NULL, cmd->argc * sizeof(uint32_t));
+
+            for (int j = 0; (j < cmd->argc) && !b->full; j++)
+            {
+                uint32_t word = shc_str(b, cmd->argv[j]);
+
+                memcpy(b->data + sc.argv + (j * sizeof(uint32_t)), &word, sizeof(uint32_t));
+            }
+
+            if (cmd->redirs_amount)
+            {
+                sc.redirs = shc_put(b, NULL, cmd->redirs_amount * sizeof(shc_redir));
+                sc.redirs_amount = cmd->redirs_amount;
+            }
+
+            for (int j = 0; (j < cmd->redirs_amount) && !b->full; j++)
+            {
+                redir *r = &cmd->redirs[j];
+
+                shc_redir sr = { r->fd, r->flags, r->dup_fd, r->file ? shc_str(b, r->file) : 0 };
+
+                if (!b->full)
+                    memcpy(b->data + sc.redirs + (j * sizeof(shc_redir)), &sr, sizeof(shc_redir));
+            }
+
+            // Sólo se guardan los paths absolutos, que no dependen del directorio actual
+            if ((cmd->builtin == _BI_NONE_) && (cmd->argv[0][0] != '\0') && !strchr(cmd->argv[0], '/'))
+            {
+                char *path = hash_lookup(cmd->argv[0]);
+
+                if (path && (path[0] == '/'))
+                    sc.path = shc_str(b, path);
+            }
+
+            if (!b->full)
+                memcpy(b->data + rec.cmds + (i * sizeof(shc_cmd)), &sc, sizeof(shc_cmd));
+        }
+    }
+
+    arena_reset(&cmd_arena);
+
+    if (!b->full)
+        memcpy(b->data + rec_off, &rec, sizeof(shc_line));
+
+    return rec_off;
+}
+
+/**
+ * @brief Esta función compila un batchfile completo.
+ *
+ * @param fd Descriptor del batchfile.
+ * @param st Datos del batchfile.
+ * @param b Donde se arma el batchfile compilado.
+ *
+ * @returns Si se pudo compilar (si no supera los 4 GB).
+ */
+static bool shc_compile(int fd, struct stat *st, shc_buf *b)
+{
+    shc_header h = { 0 };
+
+    char *path_env = getenv("PATH");
+
+    h.magic = _SHC_MAGIC_;
+    h.version = _SHC_VERSION_;
+    h.mtime_sec = st->st_mtim.tv_sec;
+    h.mtime_nsec = st->st_mtim.tv_nsec;
+    h.size = st->st_size;
+
+    shc_put(b, NULL, sizeof(shc_header));
+
+    h.path_env = shc_str(b, path_env ? path_env : "");
+
+    uint32_t *lines = NULL;
+
+    size_t lines_cap = 0;
+
+    line_reader reader;
+
+    size_t len;
+
+    char *line;
+
+    reader_init(&reader, fd);
+
+    while (!b->full && (line = reader_next(&reader, &len)) != NULL)
+    {
+        line = strtrim(line);
+
+        if (stremp(line))
+            continue;
+
+        uint32_t off = shc_compile_line(b, line);
+
+        if (off == 0)
+            continue;
+
+        if (h.lines == lines_cap)
+        {
+            lines_cap = lines_cap ? lines_cap * 2 : 256;
+
+            uint32_t *aux = (uint32_t *)realloc(lines, lines_cap * sizeof(uint32_t));
+
+            if (!aux)
+                show_err("Could not allocate memory for compiled batchfile", _FATAL_ERR_);
+
+            lines = aux;
+        }
+
+        lines[h.lines++] = off;
+    }
+
+    reader_free(&reader);
+
+    h.lines_off = shc_put(b, lines, h.lines * sizeof(uint32_t));
+    h.len = b->len;
+
+    free(lines);
+
+    if (b->full)
+        return false;
+
+    memcpy(b->data, &h, sizeof(shc_header));
+
+    return true;
+}
+
+/**
+ * @brief Esta función indica si un arreglo de un batchfile compilado
+ *        está completo dentro del archivo.
+ *
+ * @param h Encabezado del batchfile compilado.
+ * @param off Offset del arreglo.
+ * @param amount Cantidad de elementos.
+ * @param size Tamaño de cada elemento.
+ *
+ * @returns Si el arreglo es válido.
+ */
+static bool shc_span(shc_header *h, uint32_t off, int64_t amount, size_t size)
+{
+    return (off >= sizeof(shc_header)) && ((off & 7) == 0) && (amount >= 0) &&
+           (off + ((uint64_t)amount * size) <= h->len);
+}
+
+/**
+ * @brief Esta función indica si un string de un batchfile compilado
+ *        termina dentro del archivo.
+ *
+ * @param h Encabezado del batchfile compilado.
+ * @param off Offset del string.
+ * @param opt Si el string es opcional (offset 0).
+ *
+ * @returns Si el string es válido.
+ */
+static bool shc_valid_str(shc_header *h, uint32_t off, bool opt)
+{
+    if (off == 0)
+        return opt;
+
+    return (off >= sizeof(shc_header)) && (off < h->len) && memchr((char *)h + off, '\0', h->len - off);
+}
+
+/**
+ * @brief Esta función verifica todas las referencias de un batchfile
+ *        compilado.
+ *
+ * @details Un archivo dañado (o editado a mano) con el tamaño y la
+ *          fecha correctos no debe hacer que la shell lea fuera del
+ *          archivo mapeado: cada offset se verifica una sola vez al
+ *          abrirlo, y si alguno no es válido el script se vuelve a
+ *          compilar.
+ *
+ * @param h Encabezado del batchfile compilado (mapeado completo).
+ *
+ * @returns Si todas las referencias son válidas.
+ */
+static bool shc_check(shc_header *h)
+{
+    char *map = (char *)h;
+
+    if (!shc_valid_str(h, h->path_env, false) || !shc_span(h, h->lines_off, h->lines, sizeof(uint32_t)))
+        return false;
+
+    uint32_t *lines = (uint32_t *)(map + h->lines_off);
+
+    for (uint32_t i = 0; i < h->lines; i++)
+    {
+        if (!shc_span(h, lines[i], 1, sizeof(shc_line)))
+            return false;
+
+        shc_line *rec = (shc_line *)(map + lines[i]);
+
+        if (!shc_valid_str(h, rec->text, false) || !shc_valid_str(h, rec->pipe_size, true) ||
+            !shc_valid_str(h, rec->cpus, true) || !shc_valid_str(h, rec->niceness, true) ||
+            !shc_valid_str(h, rec->limits, true))
+            return false;
+
+        if (rec->cmds == 0)
+            continue;
+
+        if ((rec->cmds_amount < 1) || !shc_span(h, rec->cmds, rec->cmds_amount, sizeof(shc_cmd)))
+            return false;
+
+        shc_cmd *sc = (shc_cmd *)(map + rec->cmds);
+
+        for (int j = 0; j < rec->cmds_amount; j++)
+        {
+            if ((sc[j].argc < 1) || !shc_span(h, sc[j].argv, sc[j].argc, sizeof(uint32_t)) ||
+                (sc[j].builtin < _BI_EXPAND_) || (sc[j].builtin > _BI_TEE_) || !shc_valid_str(h, sc[j].path, true) ||
+                ((sc[j].redirs_amount > 0) && !shc_span(h, sc[j].redirs, sc[j].redirs_amount, sizeof(shc_redir))) ||
+                (sc[j].redirs_amount < 0))
+                return false;
+
+            uint32_t *words = (uint32_t *)(map + sc[j].argv);
+
+            for (int k = 0; k < sc[j].argc; k++)
+                if (!shc_valid_str(h, words[k], false))
+                    return false;
+
+            shc_redir *sr = (shc_redir *)(map + sc[j].redirs);
+
+            for (int k = 0; k < sc[j].redirs_amount; k++)
+                if (!shc_valid_str(h, sr[k].file, true))
+                    return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Esta función abre el batchfile compilado de un script, si
+ *        existe y sigue siendo válido.
+ *
+ * @details El archivo se mapea en memoria de sólo lectura, de modo que
+ *          sólo se leen del disco las páginas que se usan. Es válido si
+ *          se compiló con esta versión del formato, a partir de un script
+ *          con la misma fecha de modificación y el mismo tamaño, con
+ *          el mismo $PATH y con todas sus referencias dentro del archivo.
+ *          Además, debe pertenecer al usuario y nadie más debe poder
+ *          modificarlo, ya que determina qué programas se ejecutan.
+ *
+ * @param shc_path Path del batchfile compilado.
+ * @param st Datos del script.
+ * @param len Donde se guarda el tamaño del archivo mapeado.
+ *
+ * @returns El archivo mapeado, o NULL si no hay uno válido.
+ */
+static char *shc_load(char *shc_path, struct stat *st, size_t *len)
+{
+    struct stat shc_st;
+
+    int fd = open(shc_path, (O_RDONLY | O_CLOEXEC));
+
+    if (fd == -1)
+        return NULL;
+
+    // Otro usuario no debe poder elegir qué ejecuta la shell (por ejemplo, dejando un .shc en /tmp)
+    if ((fstat(fd, &shc_st) == -1) || !S_ISREG(shc_st.st_mode) || (shc_st.st_uid != geteuid()) ||
+        (shc_st.st_mode & (S_IWGRP | S_IWOTH)) || (shc_st.st_size < (off_t)sizeof(shc_header)) ||
+        (shc_st.st_size > UINT32_MAX))
+    {
+        close(fd);
+
+        return NULL;
+    }
+
+    char *map = mmap(NULL, shc_st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return NULL;
+
+    shc_header *h = (shc_header *)map;
+
+    char *path_env = getenv("PATH");
+
+    if ((h->magic != _SHC_MAGIC_) || (h->version != _SHC_VERSION_) || (h->len != shc_st.st_size) ||
+        (h->mtime_sec != st->st_mtim.tv_sec) || (h->mtime_nsec != st->st_mtim.tv_nsec) || (h->size != st->st_size) ||
+        !shc_check(h) || (strcmp(map + h->path_env, path_env ? path_env : "") != 0))
+    {
+        munmap(map, shc_st.st_size);
+
+        return NULL;
+    }
+
+    *len = shc_st.st_size;
+
+    return map;
+}
+
+/**
+ * @brief Esta función guarda un batchfile compilado junto a su script.
+ *
+ * @details Se escribe en un archivo temporal que luego se renombra, para
+ *          que otra ejecución nunca vea un archivo a medio escribir. Si
+ *          no se puede guardar (por ejemplo, sin permisos de escritura),
+ *          el script se ejecuta igual y se vuelve a compilar la próxima vez.
+ *          El archivo temporal tiene un nombre impredecible y se crea
+ *          nuevo, para que nadie pueda hacer que se escriba sobre otro
+ *          archivo mediante un symlink.
+ *
+ * @param shc_path Path del batchfile compilado.
+ * @param b Batchfile compilado.
+ */
+static void shc_save(char *shc_path, shc_buf *b)
+{
+    char *tmp = (char *)malloc(strlen(shc_path) + 16);
+
+    if (!tmp)
+        return;
+
+    sprintf(tmp, "%s.XXXXXX", shc_path);
+
+    // mkstemp crea un archivo nuevo (nunca sigue un symlink ya existente) con permisos 0600
+    int fd = mkostemp(tmp, O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        free(tmp);
+
+        return;
+    }
+
+    size_t done = 0;
+
+    while (done < b->len)
+    {
+        ssize_t w = write(fd, b->data + done, b->len - done);
+
+        if (w == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        done += w;
+    }
+
+    if ((close(fd) == -1) || (done < b->len) || (rename(tmp, shc_path) == -1))
+        unlink(tmp);
+
+    free(tmp);
+}
+
+/**
+ * @brief Esta función arma el árbol sintáctico de una línea compilada.
+ *
+ * @details Sólo se reservan los arreglos del árbol: los strings se
+ *          usan directamente desde el batchfile compilado.
+ *          Los paths resueltos de antemano se descartan si $PATH cambió
+ *          durante la ejecución del batchfile.
+ *
+ * @param a Arena de la que se reservan los arreglos.
+ * @param rec Línea compilada.
+ *
+ * @returns La línea analizada, válida hasta que se reinicie la arena.
+ */
+static pipeline *shc_pipeline(arena *a, shc_line *rec)
+{
+    shc_header *h = (shc_header *)script;
+
+    char *path_env = getenv("PATH");
+
+    bool paths = strcmp(script + h->path_env, path_env ? path_env : "") == 0;
+
+    pipeline *pl = (pipeline *)arena_alloc(a, sizeof(pipeline));
+
+    pl->cmds = (command *)arena_alloc(a, rec->cmds_amount * sizeof(command));
+    pl->cmds_amount = rec->cmds_amount;
+    pl->bg = rec->bg;
+    pl->timed = rec->timed;
+    pl->cpus_list = rec->cpus_list;
+    pl->spread = rec->spread;
+    pl->pipe_size = rec->pipe_size ? (script + rec->pipe_size) : NULL;
+    pl->cpus = rec->cpus ? (script + rec->cpus) : NULL;
+    pl->niceness = rec->niceness ? (script + rec->niceness) : NULL;
+    pl->limits = rec->limits ? (script + rec->limits) : NULL;
+    pl->text = script + rec->text;
+
+    shc_cmd *sc = (shc_cmd *)(script + rec->cmds);
+
+    for (int i = 0; i < rec->cmds_amount; i++)
+    {
+        command *cmd = &pl->cmds[i];
+
+        uint32_t *words = (uint32_t *)(script + sc[i].argv);
+
+        cmd->argv = (char **)arena_alloc(a, (sc[i].argc + 1) * sizeof(char *));
+        cmd->argc = sc[i].argc;
+        cmd->builtin = sc[i].builtin;
+
+        for (int j = 0; j < sc[i].argc; j++)
+            cmd->argv[j] = script + words[j];
+
+        cmd->argv[sc[i].argc] = NULL;
+
+        cmd->redirs = (redir *)arena_alloc(a, sc[i].redirs_amount * sizeof(redir));
+        cmd->redirs_amount = sc[i].redirs_amount;
+
+        shc_redir *sr = (shc_redir *)(script + sc[i].redirs);
+
+        for (int j = 0; j < sc[i].redirs_amount; j++)
+        {
+            cmd->redirs[j].fd = sr[j].fd;
+            cmd->redirs[j].flags = sr[j].flags;
+            cmd->redirs[j].dup_fd = sr[j].dup_fd;
+            cmd->redirs[j].file = sr[j].file ? script + sr[j].file : NULL;
+        }
+        cmd->path = (paths && sc[i].path) ? script + sc[i].path : NULL;
+    }
+
+    return pl;
+}
+
+/**
+ * @brief Esta función ejecuta una línea (o una estructura de control)
+ *        en el proceso actual.
+ *
+ * @param line Línea a ejecutar.
+ * @param rec Línea compilada, o NULL si hay que analizarla.
+ * @param blk Estructura de control a ejecutar en lugar de la línea, o NULL.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+static bool batch_exec(char *line, shc_line *rec, node *blk)
+{
+    if (blk)
+        return ctl_exec(blk);
+
+    if (!rec)
+        return read_line(line);
+
+    uint64_t start = stat_now();
+
+    pipeline *pl = shc_pipeline(&cmd_arena, rec);
+
+    stat_phase(_PH_PARSE_, start);
+
+    return run_line(pl, start);
+}
+
+/**
+ * @brief Esta función espera a que termine una de las líneas en
+ *        ejecución y muestra su salida.
+ *
+ * @details La salida de cada línea se guardó completa en archivos en
+ *          memoria, por lo que se la copia de una sola vez (dentro del
+ *          kernel, con stream_fd) y nunca se mezcla con la de otras
+ *          líneas. Las salidas se muestran en el orden en el que
+ *          terminan las líneas. Si no queda ninguna línea por esperar
+ *          en la tabla de trabajos, se descartan todas las que se
+ *          creían en ejecución para que quien llama deje de esperar.
+ *
+ * @returns Si terminó alguna de las líneas en ejecución.
+ */
+static bool batch_reap(void)
+{
+    int code = EXIT_SUCCESS;
+
+    jobs_block();
+
+    int id = jobs_wait_fg(&code);
+
+    jobs_unblock();
+
+    if (id == -1)
+    {
+        show_err("Lost track of the running parallel lines", _NORM_ERR_);
+
+        while (running > 0)
+        {
+            running--;
+
+            close(workers[running].out_fd);
+            close(workers[running].err_fd);
+        }
+
+        section_status = EXIT_FAILURE;
+
+        return false;
+    }
+
+    for (int i = 0; i < running; i++)
+        if (workers[i].id == id)
+        {
+            out_flush();
+
+            if ((lseek(workers[i].out_fd, 0, SEEK_SET) == -1) || !stream_fd(workers[i].out_fd, STDOUT_FILENO) ||
+                (lseek(workers[i].err_fd, 0, SEEK_SET) == -1) || !stream_fd(workers[i].err_fd, STDERR_FILENO))
+                show_err(strerror(errno), _NORM_ERR_);
+
+            close(workers[i].out_fd);
+            close(workers[i].err_fd);
+
+            workers[i] = workers[--running];
+
+            break;
+        }
+
+    if (code != EXIT_SUCCESS)
+        section_status = code;
+
+    return true;
+}
+
+/**
+ * @brief Esta función espera a que terminen todas las líneas en
+ *        ejecución (palabra clave 'barrier').
+ *
+ * @details El código de salida de la sección es el de la última línea
+ *          que falló, o 0 si todas terminaron con éxito.
+ */
+static void batch_barrier(void)
+{
+    if (running == 0)
+        return;
+
+    while ((running > 0) && batch_reap())
+        ;
+
+    last_status = section_status;
+    section_status = EXIT_SUCCESS;
+}
+
+/**
+ * @brief Esta función ejecuta una línea en paralelo con las demás.
+ *
+ * @details Si ya hay tantas líneas en ejecución como el máximo, se
+ *          espera a que termine alguna. La línea se ejecuta en una
+ *          copia de la shell, registrada en la tabla de trabajos, con
+ *          su stdout y su stderr redirigidos a archivos en memoria.
+ *          Los comandos internos que modifican el estado de la shell
+ *          (como 'cd' o 'set') sólo afectan a su propia línea.
+ *
+ * @param line Línea a ejecutar.
+ * @param rec Línea compilada, o NULL si hay que analizarla.
+ * @param blk Estructura de control a ejecutar en lugar de la línea, o NULL.
+ */
+static void batch_dispatch(char *line, shc_line *rec, node *blk)
+{
+    while ((running >= width) && batch_reap())
+        ;
+
+    if (running == workers_cap)
+    {
+        worker *aux = (worker *)realloc(workers, (workers_cap + width) * sizeof(worker));
+
+        if (!aux)
+            show_err("Could not allocate memory for parallel workers", _FATAL_ERR_);
+
+        workers = aux;
+        workers_cap += width;
+    }
+
+    worker *w = &workers[running];
+
+    w->out_fd = memfd_create("myshell-stdout", MFD_CLOEXEC);
+    w->err_fd = memfd_create("myshell-stderr", MFD_CLOEXEC);
+
+    if ((w->out_fd == -1) || (w->err_fd == -1))
+        show_err("Could not create parallel output buffers", _FATAL_ERR_);
+
+    // La copia no debe heredar salida pendiente de la shell
+    out_flush();
+
+    jobs_block();
+
+    pid_t pid = fork();
+
+    if (pid == -1)
+        show_err("Parallel fork failed", _FATAL_ERR_);
+
+    if (pid == 0)
+    {
+        jobs_unblock();
+
+        // La copia no es dueña de las demás líneas en ejecución
+        jobs_clear();
+
+        if ((dup2(w->out_fd, STDOUT_FILENO) == -1) || (dup2(w->err_fd, STDERR_FILENO) == -1))
+            try_kill(getpid(), SIGTERM);
+
+        batch_exec(line, rec, blk);
+
+        out_flush();
+
+        exit(last_status);
+    }
+
+    sh_stats.forks++;
+
+    w->id = job_add(&pid, 1, 0, blk ? blk->text : line, false);
+
+    jobs_unblock();
+
+    running++;
+}
+
+/**
+ * @brief Esta función termina la ejecución de un batchfile,
+ *        esperando a las líneas que sigan en ejecución.
+ */
+void batch_end(void)
+{
+    ctl_end();
+
+    if (in_block)
+        show_err("Invalid parallel block - missing '}'", _NORM_ERR_);
+
+    batch_barrier();
+
+    in_block = false;
+
+    free(workers);
+
+    workers = NULL;
+    workers_cap = 0;
+}
+
+/**
+ * @brief Esta función ejecuta una línea de un batchfile, ya compilada
+ *        o no (ver batch_line).
+ *
+ * @param line Línea a ejecutar (sin espacios al comienzo ni al final).
+ * @param rec Línea compilada, o NULL si hay que analizarla.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+static bool batch_run(char *line, shc_line *rec)
+{
+    node *blk = NULL;
+
+    jobs_prune();
+
+    // Las estructuras de control se leen completas y se ejecutan como una unidad
+    if (ctl_takes(line))
+    {
+        if (!(blk = ctl_feed(line, rec ? shc_pipeline(&ctl_arena, rec) : NULL)))
+            return false;
+    }
+    else if (is_keyword(line, "parallel", "{"))
+    {
+        if (in_block)
+        {
+            show_err("Invalid parallel block - blocks cannot be nested", _NORM_ERR_);
+
+            last_status = 2;
+
+            return false;
+        }
+
+        in_block = true;
+        width = batch_width;
+
+        if (width == 0)
+        {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+            width = (cpus > 0) ? (int)cpus : 1;
+        }
+
+        return false;
+    }
+
+    if (in_block && (strcmp(line, "}") == 0))
+    {
+        batch_barrier();
+
+        in_block = false;
+
+        return false;
+    }
+
+    if (strcmp(line, "barrier") == 0)
+    {
+        batch_barrier();
+
+        return false;
+    }
+
+    if (strcmp(line, "quit") == 0)
+    {
+        batch_barrier();
+
+        return true;
+    }
+
+    if (!in_block && (batch_width == 0))
+        return batch_exec(line, rec, blk);
+
+    if (!in_block)
+        width = batch_width;
+
+    batch_dispatch(line, rec, blk);
+
+    return false;
+}
+
+/**
+ * @brief Esta función ejecuta una línea de un batchfile.
+ *
+ * @details Por defecto las líneas se ejecutan en serie. Las líneas
+ *          dentro de un bloque 'parallel {' ... '}' (o todas, con la
+ *          opción '-j N') se ejecutan en paralelo, hasta N a la vez (o
+ *          tantas como procesadores, si no se indicó '-j'). La palabra
+ *          clave 'barrier' y el fin de un bloque esperan a que terminen
+ *          todas las líneas en ejecución, para separar secciones que
+ *          dependen unas de otras. 'quit' también espera antes de cerrar
+ *          la shell.
+ *
+ * @param line Línea a ejecutar (sin espacios al comienzo ni al final).
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+bool batch_line(char *line)
+{
+    return batch_run(line, NULL);
+}
+
+/**
+ * @brief Esta función ejecuta un batchfile usando su versión compilada.
+ *
+ * @details La primera vez que se ejecuta un script, se lo compila
+ *          completo (ver shc_compile_line) y se guarda el resultado
+ *          junto a él, con extensión '.shc' (bfs/name.sh > bfs/name.shc).
+ *          Las siguientes veces, mientras el script y $PATH no cambien,
+ *          se mapea el archivo compilado y sus líneas se ejecutan sin
+ *          leer ni analizar el script ni buscar sus programas.
+ *
+ * @param path Path del script.
+ * @param fd Descriptor del script.
+ *
+ * @returns Si se ejecutó el script. Si no pudo compilarse, el descriptor
+ *          queda al comienzo del script para leerlo línea por línea.
+ */
+bool batch_script(char *path, int fd)
+{
+    struct stat st;
+
+    if ((fstat(fd, &st) == -1) || !S_ISREG(st.st_mode))
+        return false;
+
+    size_t path_len = strlen(path);
+
+    // Se reemplaza la extensión '.sh' por '.shc', o se agrega '.shc'
+    char *shc_path = (char *)malloc(path_len + 5);
+
+    if (!shc_path)
+        show_err("Could not allocate memory for compiled batchfile path", _FATAL_ERR_);
+
+    strcpy(shc_path, path);
+
+    if ((path_len > 3) && (strcmp(path + path_len - 3, ".sh") == 0))
+        strcat(shc_path, "c");
+    else
+        strcat(shc_path, ".shc");
+
+    uint64_t start = stat_now();
+
+    size_t len = 0;
+
+    char *map = shc_load(shc_path, &st, &len);
+
+    script = map;
+
+    if (!script)
+    {
+        shc_buf b = { NULL, 0, 0, false };
+
+        if (!shc_compile(fd, &st, &b))
+        {
+            free(b.data);
+            free(shc_path);
+
+            lseek(fd, 0, SEEK_SET);
+
+            return false;
+        }
+
+        shc_save(shc_path, &b);
+
+        script = b.data;
+    }
+
+    stat_phase(_PH_READ_, start);
+
+    free(shc_path);
+
+    shc_header *h = (shc_header *)script;
+
+    uint32_t *lines = (uint32_t *)(script + h->lines_off);
+
+    bool quit = false;
+
+    for (uint32_t i = 0; (i < h->lines) && !quit; i++)
+    {
+        shc_line *rec = (shc_line *)(script + lines[i]);
+
+        quit = batch_run(script + rec->text, rec->cmds ? rec : NULL);
+    }
+
+    batch_end();
+
+    if (map)
+        munmap(map, len);
+    else
+        free(script);
+
+    script = NULL;
+
+    return true;
+}
@@ -0,0 +1,807 @@
+/**
+ * @file control.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con las estructuras de control de la shell
+ *        ('for', 'while' e 'if').
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/control.h"
+
+static ctl_frame *frames = NULL; // Estructuras abiertas, de la más externa a la más interna
+
+static int frames_cap = 0;
+static int depth = 0;
+static int jump = _JUMP_NONE_; // 'break' o 'continue' pendiente
+
+static node *root = NULL; // Estructura que se está leyendo
+
+static bool failed = false; // Si la estructura que se está leyendo tiene errores
+
+static volatile sig_atomic_t interrupted; // Si llegó un Ctrl+C durante la estructura en ejecución
+
+/**
+ * @brief Esta función identifica la palabra clave con la que comienza
+ *        una línea.
+ *
+ * @param line Línea a analizar (sin espacios al comienzo ni al final).
+ * @param rest Donde se guarda el resto de la línea, sin los espacios que
+ *             siguen a la palabra clave (o NULL si no hace falta).
+ *
+ * @returns El identificador de la palabra clave, o _KW_NONE_.
+ */
+static int ctl_keyword(char *line, char **rest)
+{
+    // En el mismo orden que sus identificadores
+    static char *keywords[] = { "for", "while", "if", "do", "done", "then", "elif", "else", "fi", "break", "continue" };
+
+    size_t len = 0;
+
+    while ((line[len] >= 'a') && (line[len] <= 'z'))
+        len++;
+
+    if ((line[len] != '\0') && (line[len] != ' ') && (line[len] != '\t'))
+        return _KW_NONE_;
+
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++)
+        if ((strlen(keywords[i]) == len) && (strncmp(line, keywords[i], len) == 0))
+        {
+            if (rest)
+            {
+                for (*rest = line + len; (**rest == ' ') || (**rest == '\t'); (*rest)++)
+                    ;
+            }
+
+            return (int)i;
+        }
+
+    return _KW_NONE_;
+}
+
+/**
+ * @brief Esta función informa un error en la estructura que se está
+ *        leyendo, que se descartará completa al cerrarla.
+ *
+ * @param msg Mensaje de error.
+ */
+static void ctl_error(char *msg)
+{
+    show_err(msg, _NORM_ERR_);
+
+    failed = true;
+}
+
+/**
+ * @brief Esta función informa una palabra clave fuera de lugar.
+ *
+ * @param line Línea que comienza con la palabra clave.
+ */
+static void ctl_unexpected(char *line)
+{
+    char msg[64];
+
+    int len = strcspn(line, " \t");
+
+    snprintf(msg, sizeof(msg), "Invalid control block - unexpected '%.*s'", len, line);
+
+    ctl_error(msg);
+}
+
+/**
+ * @brief Esta función copia el encabezado de una estructura, quitando
+ *        el '; do' o '; then' con el que puede terminar.
+ *
+ * @param rest Encabezado, luego de la palabra clave.
+ * @param opener Palabra que abre el cuerpo ("do" o "then").
+ * @param opened Donde se indica si el encabezado abría el cuerpo.
+ *
+ * @returns La copia del encabezado, reservada de ctl_arena.
+ */
+static char *ctl_header(char *rest, char *opener, bool *opened)
+{
+    char *copy = arena_strdup(&ctl_arena, rest);
+
+    size_t len = strlen(copy);
+    size_t opener_len = strlen(opener);
+
+    *opened = false;
+
+    if ((len > opener_len) && (strcmp(copy + len - opener_len, opener) == 0))
+    {
+        char *c = copy + len - opener_len - 1;
+
+        while ((c > copy) && ((*c == ' ') || (*c == '\t')))
+            c--;
+
+        if ((*c == ';') && ((c[1] == ' ') || (c[1] == '\t') || (c + 1 == copy + len - opener_len)))
+        {
+            *c = '\0';
+            *opened = true;
+        }
+    }
+
+    return copy;
+}
+
+/**
+ * @brief Esta función agrega un nodo a la estructura abierta más
+ *        interna (o lo toma como la estructura a leer, si no hay
+ *        ninguna abierta).
+ *
+ * @param n Nodo a agregar.
+ */
+static void ctl_append(node *n)
+{
+    if (depth == 0)
+    {
+        root = n;
+
+        return;
+    }
+
+    ctl_frame *top = &frames[depth - 1];
+
+    *top->tail = n;
+
+    top->tail = &n->next;
+    top->opened = true;
+}
+
+/**
+ * @brief Esta función abre una estructura.
+ *
+ * @param n Nodo de la estructura.
+ * @param opened Si su encabezado ya abría el cuerpo.
+ * @param chained Si es un 'elif'.
+ */
+static void ctl_push(node *n, bool opened, bool chained)
+{
+    if (depth == frames_cap)
+    {
+        int cap = frames_cap ? (frames_cap * 2) : 8;
+
+        ctl_frame *aux = (ctl_frame *)realloc(frames, cap * sizeof(ctl_frame));
+
+        if (!aux)
+            show_err("Could not allocate memory for control blocks", _FATAL_ERR_);
+
+        frames = aux;
+        frames_cap = cap;
+    }
+
+    frames[depth].blk = n;
+    frames[depth].tail = &n->body;
+    frames[depth].opened = opened;
+    frames[depth].in_else = false;
+    frames[depth].chained = chained;
+
+    depth++;
+}
+
+/**
+ * @brief Esta función arma el nodo de un 'for' a partir de su encabezado.
+ *
+ * @param n Nodo del 'for'.
+ * @param rest Encabezado, luego de 'for'.
+ *
+ * @returns Si el cuerpo ya quedó abierto con '; do'.
+ */
+static bool ctl_for_header(node *n, char *rest)
+{
+    bool opened;
+
+    char *header = ctl_header(rest, "do", &opened);
+
+    size_t len = strlen(header);
+
+    token *tokens = (token *)arena_alloc(&ctl_arena, (len + 1) * sizeof(token));
+
+    int amount = lex_line(header, tokens, (char *)arena_alloc(&ctl_arena, (len * 2) + 1));
+
+    bool ok = (amount >= 2) && (tokens[0].type == _TOK_WORD_) && (tokens[1].type == _TOK_WORD_) &&
+              is_var_name(tokens[0].word, strlen(tokens[0].word)) && (strcmp(tokens[1].word, "in") == 0);
+
+    for (int i = 2; (i < amount) && ok; i++)
+        ok = (tokens[i].type == _TOK_WORD_);
+
+    if (!ok)
+    {
+        ctl_error("Invalid for loop - expected 'for NAME in WORDS'");
+
+        return opened;
+    }
+
+    n->var = tokens[0].word;
+    n->words = (char **)arena_alloc(&ctl_arena, (amount - 1) * sizeof(char *));
+
+    for (int i = 2; i < amount; i++)
+        n->words[i - 2] = tokens[i].word;
+
+    n->words[amount - 2] = NULL;
+
+    return opened;
+}
+
+/**
+ * @brief Esta función arma la condición de un 'while', 'if' o 'elif'.
+ *
+ * @param n Nodo de la estructura.
+ * @param rest Condición, luego de la palabra clave.
+ * @param opener Palabra que abre el cuerpo ("do" o "then").
+ *
+ * @returns Si el cuerpo ya quedó abierto con '; do' o '; then'.
+ */
+static bool ctl_condition(node *n, char *rest, char *opener)
+{
+    bool opened;
+
+    char *err;
+
+    n->pl = parse_line(&ctl_arena, ctl_header(rest, opener, &opened), &err);
+
+    if (!n->pl)
+        ctl_error(err);
+    else if (n->pl->cmds_amount == 0)
+        ctl_error("Invalid control block - missing condition");
+
+    return opened;
+}
+
+/**
+ * @brief Esta función indica si una línea forma parte de una estructura
+ *        de control: si comienza con una palabra clave o si hay alguna
+ *        estructura abierta.
+ *
+ * @param line Línea a analizar (sin espacios al comienzo ni al final).
+ *
+ * @returns Si la línea debe pasarse a ctl_feed.
+ */
+bool ctl_takes(char *line)
+{
+    return (depth > 0) || (ctl_keyword(line, NULL) != _KW_NONE_);
+}
+
+/**
+ * @brief Esta función agrega una línea a la estructura de control que
+ *        se está leyendo.
+ *
+ * @details Las estructuras se leen completas antes de ejecutarlas, y
+ *          cada línea se analiza una única vez, de modo que los cuerpos
+ *          de los bucles se vuelven a ejecutar sin volver a analizarlos.
+ *          Sintaxis (cada parte en su propia línea):
+ *          - for NOMBRE in PALABRAS... [; do] ... done
+ *          - while COMANDO [; do] ... done
+ *          - if COMANDO [; then] ... [elif COMANDO [; then] ...] [else ...] fi
+ *          Las líneas 'do' y 'then' son opcionales. Dentro de los bucles
+ *          pueden usarse 'break' y 'continue'. Si la estructura tiene
+ *          errores, se los informa y se la descarta completa.
+ *          Toda la memoria de la estructura sale de ctl_arena, que se
+ *          reinicia al comenzar a leer la siguiente.
+ *
+ * @param line Línea a agregar (sin espacios al comienzo ni al final).
+ * @param pl La línea ya analizada (reservada de ctl_arena), o NULL para
+ *           analizarla aquí.
+ *
+ * @returns La estructura completa, cuando se lee su cierre, o NULL si
+ *          todavía está abierta o tenía errores.
+ */
+node *ctl_feed(char *line, pipeline *pl)
+{
+    char *rest;
+
+    char *err;
+
+    int kw = ctl_keyword(line, &rest);
+
+    ctl_frame *top = (depth > 0) ? &frames[depth - 1] : NULL;
+
+    if (depth == 0)
+    {
+        arena_reset(&ctl_arena);
+
+        root = NULL;
+        failed = false;
+    }
+
+    // Las palabras clave que cierran o separan partes van solas en su línea
+    if ((kw >= _KW_DO_) && (kw != _KW_ELIF_) && (*rest != '\0') && (*rest != '#'))
+        kw = _KW_NONE_;
+
+    switch (kw)
+    {
+        case _KW_FOR_:
+        case _KW_WHILE_:
+        case _KW_IF_:
+        {
+            node *n = (node *)arena_calloc(&ctl_arena, 1, sizeof(node));
+
+            bool opened;
+
+            n->text = arena_strdup(&ctl_arena, line);
+
+            if (kw == _KW_FOR_)
+            {
+                n->type = _NODE_FOR_;
+
+                opened = ctl_for_header(n, rest);
+            }
+            else
+            {
+                n->type = (kw == _KW_WHILE_) ? _NODE_WHILE_ : _NODE_IF_;
+
+                opened = ctl_condition(n, rest, (kw == _KW_WHILE_) ? "do" : "then");
+            }
+
+            ctl_append(n);
+            ctl_push(n, opened, false);
+
+            break;
+        }
+
+        case _KW_DO_:
+        case _KW_THEN_:
+        {
+            if (!top || top->opened || ((kw == _KW_DO_) == (top->blk->type == _NODE_IF_)))
+                ctl_unexpected(line);
+            else
+                top->opened = true;
+
+            break;
+        }
+
+        case _KW_ELIF_:
+        case _KW_ELSE_:
+        {
+            if (!top || (top->blk->type != _NODE_IF_) || top->in_else)
+            {
+                ctl_unexpected(line);
+
+                break;
+            }
+
+            top->in_else = true;
+            top->tail = &top->blk->alt;
+
+            if (kw == _KW_ELIF_)
+            {
+                node *n = (node *)arena_calloc(&ctl_arena, 1, sizeof(node));
+
+                n->type = _NODE_IF_;
+                n->text = arena_strdup(&ctl_arena, line);
+
+                bool opened = ctl_condition(n, rest, "then");
+
+                top->blk->alt = n;
+
+                ctl_push(n, opened, true);
+            }
+
+            break;
+        }
+
+        case _KW_DONE_:
+        {
+            if (!top || (top->blk->type == _NODE_IF_))
+                ctl_unexpected(line);
+            else
+                depth--;
+
+            break;
+        }
+
+        case _KW_FI_:
+        {
+            if (!top || (top->blk->type != _NODE_IF_))
+            {
+                ctl_unexpected(line);
+
+                break;
+            }
+
+            while (frames[depth - 1].chained)
+                depth--;
+
+            depth--;
+
+            break;
+        }
+
+        case _KW_BREAK_:
+        case _KW_CONTINUE_:
+        {
+            if (!top)
+            {
+                ctl_unexpected(line);
+
+                break;
+            }
+
+            node *n = (node *)arena_calloc(&ctl_arena, 1, sizeof(node));
+
+            n->type = (kw == _KW_BREAK_) ? _NODE_BREAK_ : _NODE_CONTINUE_;
+            n->text = arena_strdup(&ctl_arena, line);
+
+            ctl_append(n);
+
+            break;
+        }
+
+        default:
+        {
+            if (!pl && !(pl = parse_line(&ctl_arena, line, &err)))
+                ctl_error(err);
+            else if (pl->cmds_amount > 0)
+            {
+                node *n = (node *)arena_calloc(&ctl_arena, 1, sizeof(node));
+
+                n->type = _NODE_CMD_;
+                n->text = pl->text;
+                n->pl = pl;
+
+                ctl_append(n);
+            }
+
+            break;
+        }
+    }
+
+    if (depth > 0)
+        return NULL;
+
+    if (failed)
+    {
+        sh_stats.parse_errors++;
+
+        last_status = 2; // Error de sintaxis, como en sh
+
+        return NULL;
+    }
+
+    return root;
+}
+
+/**
+ * @brief Esta función atiende la signal SIGINT mientras se ejecuta
+ *        una estructura de control.
+ *
+ * @param sig Signal recibida.
+ */
+static void ctl_sigint(int sig)
+{
+    (void)sig;
+
+    interrupted = 1;
+}
+
+/**
+ * @brief Esta función indica si hay que interrumpir la estructura en
+ *        ejecución por un Ctrl+C.
+ *
+ * @details Los comandos internos se ejecutan en el proceso de la shell,
+ *          que no termina con SIGINT, por lo que un bucle formado sólo
+ *          por ellos se detiene recién al revisar esta marca.
+ *
+ * @returns Si hay que interrumpir la estructura.
+ */
+static bool ctl_interrupted(void)
+{
+    if (interrupted)
+        jump = _JUMP_ABORT_;
+
+    return jump == _JUMP_ABORT_;
+}
+
+/**
+ * @brief Esta función ejecuta un comando de una estructura de control.
+ *
+ * @details Si el comando termina por un Ctrl+C, se interrumpe toda la
+ *          estructura, para que el usuario pueda detener un bucle.
+ *
+ * @param pl Comando ya analizado.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+static bool ctl_cmd(pipeline *pl)
+{
+    bool quit = run_line(pl, stat_now());
+
+    if (last_status == 128 + SIGINT)
+        interrupted = 1;
+
+    if (ctl_interrupted())
+        last_status = 128 + SIGINT;
+
+    return quit;
+}
+
+static bool ctl_run(node *);
+
+/**
+ * @brief Esta función indica si un 'for' recorre un rango numérico
+ *        de la forma {DESDE..HASTA}.
+ *
+ * @param word Palabra ya expandida.
+ * @param from Donde se guarda el comienzo del rango.
+ * @param to Donde se guarda el final del rango (incluido).
+ *
+ * @returns Si la palabra es un rango.
+ */
+static bool ctl_range(char *word, long *from, long *to)
+{
+    char *end;
+
+    if (word[0] != '{')
+        return false;
+
+    *from = strtol(word + 1, &end, 10);
+
+    if ((end == word + 1) || (strncmp(end, "..", 2) != 0))
+        return false;
+
+    char *start = end + 2;
+
+    *to = strtol(start, &end, 10);
+
+    return (end != start) && (strcmp(end, "}") == 0);
+}
+
+/**
+ * @brief Esta función ejecuta un 'for'.
+ *
+ * @details Cada palabra se expande al llegar a ella, y un rango
+ *          {DESDE..HASTA} se recorre sin armar la lista de números.
+ *          El código de salida es el del último comando del cuerpo.
+ *
+ * @param n Nodo del 'for'.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+static bool ctl_for(node *n)
+{
+    arena words = { NULL }; // Palabra expandida que se está recorriendo
+
+    char number[24];
+
+    bool quit = false;
+    bool stop = false;
+
+    int status = EXIT_SUCCESS;
+
+    for (char **w = n->words; *w && !quit && !stop; w++)
+    {
+        char *value = expand_word(&words, *w);
+
+        long from = 0;
+        long to = 0;
+
+        bool range = ctl_range(value, &from, &to);
+
+        for (long i = from; !quit; i += (to >= from) ? 1 : -1)
+        {
+            if (ctl_interrupted())
+            {
+                stop = true;
+
+                break;
+            }
+
+            if (range)
+            {
+                snprintf(number, sizeof(number), "%ld", i);
+
+                var_set(n->var, number);
+            }
+            else
+                var_set(n->var, value);
+
+            quit = ctl_run(n->body);
+            status = last_status;
+
+            if (jump != _JUMP_CONTINUE_)
+                stop = (jump != _JUMP_NONE_);
+
+            if (jump != _JUMP_ABORT_)
+                jump = _JUMP_NONE_;
+
+            if (stop || !range || (i == to))
+                break;
+        }
+
+        arena_reset(&words);
+    }
+
+    arena_free(&words);
+
+    last_status = (jump == _JUMP_ABORT_) ? 128 + SIGINT : status;
+
+    return quit;
+}
+
+/**
+ * @brief Esta función ejecuta un 'while'.
+ *
+ * @details El código de salida es el del último comando del cuerpo,
+ *          o 0 si el cuerpo no llegó a ejecutarse.
+ *
+ * @param n Nodo del 'while'.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+static bool ctl_while(node *n)
+{
+    bool quit = false;
+
+    int status = EXIT_SUCCESS;
+
+    while (!quit && !ctl_interrupted())
+    {
+        quit = ctl_cmd(n->pl);
+
+        if (quit || (last_status != EXIT_SUCCESS) || (jump == _JUMP_ABORT_))
+            break;
+
+        quit = ctl_run(n->body);
+        status = last_status;
+
+        if ((jump == _JUMP_BREAK_) || (jump == _JUMP_ABORT_))
+            break;
+
+        jump = _JUMP_NONE_;
+    }
+
+    if (jump != _JUMP_ABORT_)
+        jump = _JUMP_NONE_;
+
+    last_status = (jump == _JUMP_ABORT_) ? 128 + SIGINT : status;
+
+    return quit;
+}
+
+/**
+ * @brief Esta función ejecuta los nodos de un bloque, en orden.
+ *
+ * @details Se deja de ejecutar el bloque ante un 'break' o 'continue',
+ *          que resuelve el bucle que lo contiene.
+ *
+ * @param n Primer nodo del bloque.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+static bool ctl_run(node *n)
+{
+    bool quit = false;
+
+    for (; n && !quit && (jump == _JUMP_NONE_); n = n->next)
+        switch (n->type)
+        {
+            case _NODE_CMD_:
+            {
+                quit = ctl_cmd(n->pl);
+
+                break;
+            }
+
+            case _NODE_FOR_:
+            {
+                quit = ctl_for(n);
+
+                break;
+            }
+
+            case _NODE_WHILE_:
+            {
+                quit = ctl_while(n);
+
+                break;
+            }
+
+            case _NODE_IF_:
+            {
+                quit = ctl_cmd(n->pl);
+
+                if (quit || (jump != _JUMP_NONE_))
+                    break;
+
+                node *branch = (last_status == EXIT_SUCCESS) ? n->body : n->alt;
+
+                if (branch)
+                    quit = ctl_run(branch);
+                else
+                    last_status = EXIT_SUCCESS;
+
+                break;
+            }
+
+            default:
+            {
+                jump = (n->type == _NODE_BREAK_) ? _JUMP_BREAK_ : _JUMP_CONTINUE_;
+
+                break;
+            }
+        }
+
+    return quit;
+}
+
+/**
+ * @brief Esta función ejecuta una estructura de control completa en el
+ *        proceso de la shell.
+ *
+ * @details Mientras se ejecuta, un Ctrl+C (que la shell normalmente
+ *          ignora) interrumpe la estructura con código de salida 130.
+ *
+ * @param blk Estructura devuelta por ctl_feed.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+bool ctl_exec(node *blk)
+{
+    struct sigaction action;
+    struct sigaction old_action;
+
+    memset(&action, 0, sizeof(action));
+
+    action.sa_handler = ctl_sigint;
+    action.sa_flags = SA_RESTART;
+
+    sigemptyset(&action.sa_mask);
+
+    jump = _JUMP_NONE_;
+    interrupted = 0;
+
+    sigaction(SIGINT, &action, &old_action);
+
+    bool quit = ctl_run(blk);
+
+    sigaction(SIGINT, &old_action, NULL);
+
+    jump = _JUMP_NONE_;
+    interrupted = 0;
+
+    return quit;
+}
+
+/**
+ * @brief Esta función ejecuta una línea ingresada por el usuario,
+ *        teniendo en cuenta las estructuras de control.
+ *
+ * @param line Línea a ejecutar (sin espacios al comienzo ni al final).
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+bool ctl_line(char *line)
+{
+    if (!ctl_takes(line))
+        return read_line(line);
+
+    node *blk = ctl_feed(line, NULL);
+
+    return blk ? ctl_exec(blk) : false;
+}
+
+/**
+ * @brief Esta función descarta la estructura de control que se estaba
+ *        leyendo al terminar la entrada, informando que quedó abierta.
+ */
+void ctl_end(void)
+{
+    if (depth > 0)
+    {
+        show_err("Invalid control block - missing 'done' or 'fi'", _NORM_ERR_);
+
+        sh_stats.parse_errors++;
+
+        last_status = 2;
+    }
+
+    depth = 0;
+    root = NULL;
+
+    free(frames);
+
+    frames = NULL;
+    frames_cap = 0;
+
+    arena_free(&ctl_arena);
+}
@@ -0,0 +1,652 @@
+/**
+ * @file jobs.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con la tabla de trabajos (jobs) de la shell
+ *        y el manejo de la señal SIGCHLD.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/jobs.h"
+
+/**
+ * @brief Esta función traduce el estado devuelto por 'wait4'
+ *        al código de salida de un proceso.
+ *
+ * @param status Estado devuelto por 'wait4'.
+ *
+ * @returns El código de salida del proceso, o 128 + el número de
+ *          la señal que lo terminó o detuvo.
+ */
+static int status_code(int status)
+{
+    if (WIFEXITED(status))
+        return WEXITSTATUS(status);
+
+    if (WIFSIGNALED(status))
+        return 128 + WTERMSIG(status);
+
+    if (WIFSTOPPED(status))
+        return 128 + WSTOPSIG(status);
+
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Esta función actualiza el estado del proceso y del
+ *        trabajo correspondientes a un ID de proceso.
+ *
+ * @details Se llama desde el handler de SIGCHLD, por lo que sólo
+ *          utiliza funciones async-signal-safe y no modifica la
+ *          estructura de la tabla.
+ *
+ * @param pid ID del proceso que cambió de estado.
+ * @param status Estado devuelto por 'wait4'.
+ * @param usage Recursos consumidos por el proceso.
+ */
+static void proc_update(pid_t pid, int status, struct rusage *usage)
+{
+    for (int i = 0; i < jobs_amount; i++)
+    {
+        job *j = &jobs_table[i];
+
+        for (int k = 0; k < j->procs_amount; k++)
+        {
+            proc *p = &j->procs[k];
+
+            if ((p->pid != pid) || p->done)
+                continue;
+
+            if (WIFSTOPPED(status))
+            {
+                p->stopped = true;
+                p->status = status;
+            }
+            else if (WIFCONTINUED(status))
+                p->stopped = false;
+            else
+            {
+                p->done = true;
+                p->stopped = false;
+                p->status = status;
+                p->usage = *usage;
+
+                clock_gettime(CLOCK_MONOTONIC, &p->end);
+
+                j->alive--;
+            }
+
+            // El trabajo está detenido si alguno de sus procesos vivos lo está
+            j->state = _JOB_RUNNING_;
+
+            if (j->alive == 0)
+            {
+                j->state = _JOB_DONE_;
+                j->end = p->end;
+            }
+            else
+                for (int m = 0; m < j->procs_amount; m++)
+                    if (!j->procs[m].done && j->procs[m].stopped)
+                        j->state = _JOB_STOPPED_;
+
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Handler de la señal SIGCHLD.
+ *
+ * @details Se recolectan todos los child processes que cambiaron de
+ *          estado, evitando que queden procesos zombie. Todos los
+ *          procesos que lanza la shell pertenecen a algún trabajo de
+ *          la tabla, por lo que éste es el único lugar donde se los
+ *          espera.
+ *
+ * @param sig Señal recibida.
+ */
+static void sigchld_handler(int sig)
+{
+    int saved_errno = errno;
+    int status;
+
+    pid_t pid;
+
+    struct rusage usage;
+
+    (void)sig;
+
+    while ((pid = wait4(-1, &status, (WNOHANG | WUNTRACED | WCONTINUED), &usage)) > 0)
+        proc_update(pid, status, &usage);
+
+    errno = saved_errno;
+}
+
+/**
+ * @brief Esta función elimina un trabajo de la tabla.
+ *
+ * @details Debe llamarse con SIGCHLD bloqueada.
+ *
+ * @param index Posición del trabajo en la tabla.
+ */
+static void job_remove(int index)
+{
+    free(jobs_table[index].procs);
+    free(jobs_table[index].cmd);
+
+    memmove(&jobs_table[index], &jobs_table[index + 1], (jobs_amount - index - 1) * sizeof(job));
+
+    jobs_amount--;
+}
+
+/**
+ * @brief Esta función devuelve una descripción del estado de un trabajo.
+ *
+ * @param j Trabajo a describir.
+ * @param buffer Buffer donde se escribe la descripción.
+ * @param size Tamaño del buffer.
+ */
+static void job_state_str(job *j, char *buffer, size_t size)
+{
+    if (j->state == _JOB_RUNNING_)
+        snprintf(buffer, size, "Running");
+    else if (j->state == _JOB_STOPPED_)
+        snprintf(buffer, size, "Stopped");
+    else if (job_code(j) == 0)
+        snprintf(buffer, size, "Done");
+    else
+        snprintf(buffer, size, "Exit %d", job_code(j));
+}
+
+/**
+ * @brief Esta función bloquea la señal SIGCHLD.
+ *
+ * @details Mientras la señal está bloqueada, la tabla de trabajos
+ *          puede modificarse de manera segura.
+ */
+void jobs_block(void)
+{
+    sigset_t mask;
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1)
+        show_err("Could not block SIGCHLD", _FATAL_ERR_);
+}
+
+/**
+ * @brief Esta función vacía la tabla de trabajos.
+ *
+ * @details Se utiliza en las copias de la shell, que heredan la tabla
+ *          pero no son las dueñas de esos trabajos. No se envía ninguna
+ *          señal a sus procesos.
+ */
+void jobs_clear(void)
+{
+    jobs_block();
+
+    while (jobs_amount > 0)
+        job_remove(jobs_amount - 1);
+
+    jobs_unblock();
+}
+
+/**
+ * @brief Esta función instala el handler de SIGCHLD.
+ *
+ * @details Se utiliza SA_RESTART para que las llamadas al sistema
+ *          interrumpidas por la señal se reanuden solas. Además, se
+ *          ignora SIGTTOU para que la shell pueda recuperar la
+ *          terminal luego de cederla con 'fg'.
+ */
+void jobs_init(void)
+{
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+
+    sa.sa_handler = sigchld_handler;
+    sa.sa_flags = SA_RESTART;
+
+    sigemptyset(&sa.sa_mask);
+
+    if ((sigaction(SIGCHLD, &sa, NULL) == -1) || (signal(SIGTTOU, SIG_IGN) == SIG_ERR))
+        show_err("Could not install SIGCHLD handler", _FATAL_ERR_);
+}
+
+/**
+ * @brief Esta función informa los trabajos en background que
+ *        terminaron y los elimina de la tabla.
+ */
+void jobs_notify(void)
+{
+    jobs_block();
+
+    for (int i = 0; i < jobs_amount; i++)
+        if (jobs_table[i].bg && (jobs_table[i].state == _JOB_DONE_))
+        {
+            char state[16];
+            char line[_STR_MAX_LEN_ + 64];
+
+            job_state_str(&jobs_table[i], state, sizeof(state));
+
+            snprintf(line, sizeof(line), "[%d]  %-8s %s\n", jobs_table[i].id, state, jobs_table[i].cmd);
+
+            out_write(line);
+
+            job_remove(i--);
+        }
+
+    jobs_unblock();
+}
+
+/**
+ * @brief Esta función elimina sin informarlos los trabajos en
+ *        background terminados más antiguos.
+ *
+ * @details Fuera del modo interactivo nadie ve los avisos de
+ *          jobs_notify, por lo que los trabajos terminados sólo saldrían
+ *          de la tabla con 'jobs' o 'wait'. Con cientos de trabajos en
+ *          background, la tabla crecería sin límite y con ella cada
+ *          recorrido del handler de SIGCHLD. Se conservan los últimos
+ *          _JOBS_KEEP_, para que 'wait' pueda obtener su código de salida.
+ *          La tabla se compacta en una sola pasada.
+ */
+void jobs_prune(void)
+{
+    int done = 0;
+
+    // El handler de SIGCHLD no agrega ni quita trabajos, por lo que basta con contarlos
+    for (int i = 0; i < jobs_amount; i++)
+        if (jobs_table[i].bg && (jobs_table[i].state == _JOB_DONE_))
+            done++;
+
+    if (done <= _JOBS_KEEP_)
+        return;
+
+    jobs_block();
+
+    int excess = -_JOBS_KEEP_;
+    int kept = 0;
+
+    for (int i = 0; i < jobs_amount; i++)
+        if (jobs_table[i].bg && (jobs_table[i].state == _JOB_DONE_))
+            excess++;
+
+    for (int i = 0; i < jobs_amount; i++)
+    {
+        if ((excess > 0) && jobs_table[i].bg && (jobs_table[i].state == _JOB_DONE_))
+        {
+            free(jobs_table[i].procs);
+            free(jobs_table[i].cmd);
+
+            excess--;
+
+            continue;
+        }
+
+        jobs_table[kept++] = jobs_table[i];
+    }
+
+    jobs_amount = kept;
+
+    jobs_unblock();
+}
+
+/**
+ * @brief Esta función muestra la tabla de trabajos.
+ *
+ * @details Por cada trabajo se muestra su número, estado, ID del
+ *          primer proceso, tiempo transcurrido y línea de comandos.
+ *          Los trabajos terminados se eliminan luego de mostrarse.
+ */
+void jobs_show(void)
+{
+    jobs_block();
+
+    for (int i = 0; i < jobs_amount; i++)
+    {
+        char state[16];
+        char line[_STR_MAX_LEN_ + 64];
+
+        job_state_str(&jobs_table[i], state, sizeof(state));
+
+        snprintf(line, sizeof(line), "[%d]  %-8s %7d %10.3fs  %s\n", jobs_table[i].id, state,
+                 jobs_table[i].procs[0].pid, job_elapsed(&jobs_table[i]), jobs_table[i].cmd);
+
+        out_write(line);
+
+        if (jobs_table[i].state == _JOB_DONE_)
+            job_remove(i--);
+    }
+
+    jobs_unblock();
+}
+
+/**
+ * @brief Esta función desbloquea la señal SIGCHLD.
+ */
+void jobs_unblock(void)
+{
+    sigset_t mask;
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+
+    if (sigprocmask(SIG_UNBLOCK, &mask, NULL) == -1)
+        show_err("Could not unblock SIGCHLD", _FATAL_ERR_);
+}
+
+/**
+ * @brief Esta función agrega un trabajo a la tabla.
+ *
+ * @details Debe llamarse con SIGCHLD bloqueada desde antes de lanzar
+ *          los procesos, para que ninguno termine sin estar en la tabla.
+ *
+ * @param pids IDs de los procesos del trabajo.
+ * @param pids_amount Cantidad de procesos.
+ * @param pgid Grupo de procesos del trabajo, o 0.
+ * @param cmd Línea de comandos que originó el trabajo.
+ * @param bg Si el trabajo se ejecuta en background.
+ *
+ * @returns El número del trabajo agregado.
+ */
+int job_add(pid_t *pids, int pids_amount, pid_t pgid, char *cmd, bool bg)
+{
+    if (jobs_amount == jobs_cap)
+    {
+        int new_cap = jobs_cap ? (jobs_cap * 2) : 16;
+
+        job *aux_table = (job *)realloc(jobs_table, new_cap * sizeof(job));
+
+        if (!aux_table)
+            show_err("Could not allocate memory for jobs table", _FATAL_ERR_);
+
+        jobs_table = aux_table;
+        jobs_cap = new_cap;
+    }
+
+    job *j = &jobs_table[jobs_amount];
+
+    memset(j, 0, sizeof(job));
+
+    j->id = jobs_amount ? (jobs_table[jobs_amount - 1].id + 1) : 1;
+    j->state = _JOB_RUNNING_;
+    j->alive = pids_amount;
+    j->pgid = pgid;
+    j->bg = bg;
+    j->procs_amount = pids_amount;
+    j->procs = (proc *)calloc(pids_amount, sizeof(proc));
+    j->cmd = strdup(cmd);
+
+    if (!j->procs || !j->cmd)
+        show_err("Could not allocate memory for jobs table", _FATAL_ERR_);
+
+    for (int i = 0; i < pids_amount; i++)
+        j->procs[i].pid = pids[i];
+
+    clock_gettime(CLOCK_MONOTONIC, &j->start);
+
+    jobs_amount++;
+
+    return j->id;
+}
+
+/**
+ * @brief Esta función devuelve el código de salida de un trabajo.
+ *
+ * @param j Trabajo terminado o detenido.
+ *
+ * @returns El código de salida de su último proceso.
+ */
+int job_code(job *j)
+{
+    return proc_code(&j->procs[j->procs_amount - 1]);
+}
+
+/**
+ * @brief Esta función espera a que un trabajo termine.
+ *
+ * @details Debe llamarse con SIGCHLD bloqueada. Se suspende la shell
+ *          con 'sigsuspend' hasta que el handler de SIGCHLD marque el
+ *          trabajo como terminado (o detenido, si así se indica). Si
+ *          terminó, se lo elimina de la tabla; si se detuvo, queda en
+ *          ella como trabajo en background detenido.
+ *
+ * @param id Número del trabajo.
+ * @param until_stop Si también se retorna cuando el trabajo se detiene.
+ * @param procs Donde se copian los procesos del trabajo si terminó
+ *              (con sus recursos consumidos), o NULL.
+ *
+ * @returns El código de salida del trabajo, o 127 si no existe.
+ */
+int job_wait(int id, bool until_stop, proc *procs)
+{
+    sigset_t wait_mask;
+
+    job *j = job_get(id);
+
+    if (!j)
+        return 127;
+
+    uint64_t start = stat_now();
+
+    sigprocmask(SIG_SETMASK, NULL, &wait_mask);
+    sigdelset(&wait_mask, SIGCHLD);
+
+    while ((j->state == _JOB_RUNNING_) || (!until_stop && (j->state == _JOB_STOPPED_)))
+        sigsuspend(&wait_mask);
+
+    sh_stats.line_wait_ns += stat_phase(_PH_WAIT_, start);
+
+    int code = job_code(j);
+
+    if (j->state == _JOB_STOPPED_)
+    {
+        char line[_STR_MAX_LEN_ + 64];
+
+        j->bg = true;
+
+        snprintf(line, sizeof(line), "\n[%d]  Stopped  %s\n", j->id, j->cmd);
+
+        out_write(line);
+    }
+    else
+    {
+        if (procs)
+            memcpy(procs, j->procs, j->procs_amount * sizeof(proc));
+
+        job_remove(j - jobs_table);
+    }
+
+    return code;
+}
+
+/**
+ * @brief Esta función devuelve el código de salida de un proceso.
+ *
+ * @param p Proceso terminado o detenido.
+ *
+ * @returns El código de salida del proceso, o 128 + el número de
+ *          la señal que lo terminó o detuvo.
+ */
+int proc_code(proc *p)
+{
+    return status_code(p->status);
+}
+
+/**
+ * @brief Esta función espera a que termine cualquiera de los
+ *        trabajos en background.
+ *
+ * @details Debe llamarse con SIGCHLD bloqueada. Si algún trabajo ya
+ *          había terminado, se lo toma sin esperar.
+ *
+ * @returns El código de salida del trabajo que terminó, o 127 si no
+ *          hay trabajos en background.
+ */
+int jobs_wait_any(void)
+{
+    sigset_t wait_mask;
+
+    uint64_t start = stat_now();
+
+    sigprocmask(SIG_SETMASK, NULL, &wait_mask);
+    sigdelset(&wait_mask, SIGCHLD);
+
+    while (true)
+    {
+        bool any = false;
+
+        for (int i = 0; i < jobs_amount; i++)
+        {
+            if (!jobs_table[i].bg)
+                continue;
+
+            if (jobs_table[i].state == _JOB_DONE_)
+            {
+                int code = job_code(&jobs_table[i]);
+
+                job_remove(i);
+
+                sh_stats.line_wait_ns += stat_phase(_PH_WAIT_, start);
+
+                return code;
+            }
+
+            any = true;
+        }
+
+        if (!any)
+            return 127;
+
+        sigsuspend(&wait_mask);
+    }
+}
+
+/**
+ * @brief Esta función espera a que termine cualquiera de los
+ *        trabajos en foreground que siguen en la tabla.
+ *
+ * @details Debe llamarse con SIGCHLD bloqueada. Los trabajos en
+ *          foreground sólo quedan en la tabla mientras se ejecutan
+ *          las líneas de una sección paralela de un batchfile, que
+ *          se esperan en el orden en el que terminan.
+ *
+ * @param code Donde se guarda el código de salida del trabajo.
+ *
+ * @returns El número del trabajo que terminó, o -1 si no hay
+ *          trabajos en foreground.
+ */
+int jobs_wait_fg(int *code)
+{
+    sigset_t wait_mask;
+
+    uint64_t start = stat_now();
+
+    sigprocmask(SIG_SETMASK, NULL, &wait_mask);
+    sigdelset(&wait_mask, SIGCHLD);
+
+    while (true)
+    {
+        bool any = false;
+
+        for (int i = 0; i < jobs_amount; i++)
+        {
+            if (jobs_table[i].bg)
+                continue;
+
+            if (jobs_table[i].state == _JOB_DONE_)
+            {
+                int id = jobs_table[i].id;
+
+                *code = job_code(&jobs_table[i]);
+
+                job_remove(i);
+
+                stat_phase(_PH_WAIT_, start);
+
+                return id;
+            }
+
+            any = true;
+        }
+
+        if (!any)
+            return -1;
+
+        sigsuspend(&wait_mask);
+    }
+}
+
+/**
+ * @brief Esta función calcula el tiempo transcurrido desde que se
+ *        lanzó un trabajo hasta que terminó (o hasta ahora).
+ *
+ * @param j Trabajo a medir.
+ *
+ * @returns El tiempo transcurrido en segundos.
+ */
+double job_elapsed(job *j)
+{
+    struct timespec end = j->end;
+
+    if (j->state != _JOB_DONE_)
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (double)(end.tv_sec - j->start.tv_sec) + ((double)(end.tv_nsec - j->start.tv_nsec) / 1e9);
+}
+
+/**
+ * @brief Esta función busca un trabajo a partir de su especificación.
+ *
+ * @param spec "%n" para el trabajo número n, un ID de proceso, o
+ *             NULL, "%%" o "%+" para el trabajo más reciente.
+ *
+ * @returns El trabajo encontrado, o NULL si no existe.
+ */
+job *job_find(char *spec)
+{
+    if (!spec || (strcmp(spec, "%%") == 0) || (strcmp(spec, "%+") == 0))
+    {
+        for (int i = jobs_amount - 1; i >= 0; i--)
+            if (jobs_table[i].bg)
+                return &jobs_table[i];
+
+        return NULL;
+    }
+
+    char *end;
+
+    long value = strtol(spec + (spec[0] == '%'), &end, 10);
+
+    if ((*end != '\0') || (end == spec + (spec[0] == '%')))
+        return NULL;
+
+    if (spec[0] == '%')
+        return job_get((int)value);
+
+    for (int i = 0; i < jobs_amount; i++)
+        for (int k = 0; k < jobs_table[i].procs_amount; k++)
+            if (jobs_table[i].procs[k].pid == (pid_t)value)
+                return &jobs_table[i];
+
+    return NULL;
+}
+
+/**
+ * @brief Esta función busca un trabajo a partir de su número.
+ *
+ * @param id Número del trabajo.
+ *
+ * @returns El trabajo encontrado, o NULL si no existe.
+ */
+job *job_get(int id)
+{
+    for (int i = 0; i < jobs_amount; i++)
+        if (jobs_table[i].id == id)
+            return &jobs_table[i];
+
+    return NULL;
+}
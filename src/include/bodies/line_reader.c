@@ -0,0 +1,164 @@
+/**
+ * @file line_reader.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con un lector de líneas con buffer
+ *        para file descriptors.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/line_reader.h"
+
+/**
+ * @brief Esta función libera la memoria de un lector de líneas.
+ *
+ * @details No se cierra el file descriptor asociado.
+ *
+ * @param reader Lector a liberar.
+ */
+void reader_free(line_reader *reader)
+{
+    free(reader->buf);
+
+    reader->buf = NULL;
+}
+
+/**
+ * @brief Esta función inicializa un lector de líneas sobre un
+ *        file descriptor ya abierto.
+ *
+ * @details El buffer comienza con _READ_BUF_LEN_ bytes y crece a
+ *          medida que hagan falta líneas más largas, hasta el máximo
+ *          largo de argumentos que acepta el sistema (ARG_MAX).
+ *
+ * @param reader Lector a inicializar.
+ * @param fd File descriptor del que se leerán las líneas.
+ */
+void reader_init(line_reader *reader, int fd)
+{
+    reader->fd = fd;
+    reader->cap = _READ_BUF_LEN_;
+
+    long arg_max = sysconf(_SC_ARG_MAX);
+
+    reader->max = (arg_max > _READ_BUF_LEN_) ? (size_t)arg_max : _READ_BUF_LEN_;
+    reader->start = 0;
+    reader->end = 0;
+    reader->eof = false;
+    reader->skip = false;
+
+    // + 1 por el '\0' de una última línea que ocupe todo el buffer
+    reader->buf = (char *)malloc(reader->cap + 1);
+
+    if (!reader->buf)
+        show_err("Could not allocate memory for line reader buffer", _FATAL_ERR_);
+}
+
+/**
+ * @brief Esta función devuelve la próxima línea disponible.
+ *
+ * @details Se lee del file descriptor de a bloques tan grandes
+ *          como el lugar libre en el buffer y se buscan los saltos
+ *          de línea con 'memchr', por lo que un mismo 'read' puede
+ *          proveer muchas líneas. Una línea incompleta se conserva
+ *          para la siguiente lectura, y si no entra en el buffer se
+ *          lo agranda al doble. Las líneas más largas que ARG_MAX
+ *          se informan como error y se descartan completas.
+ *          La línea devuelta termina en '\0' (sin el salto de línea)
+ *          y sólo es válida hasta la siguiente llamada.
+ *
+ * @param reader Lector del que se toma la línea.
+ * @param len Donde se guarda el largo de la línea.
+ *
+ * @returns La línea leída, o NULL si se alcanzó el EOF.
+ */
+char *reader_next(line_reader *reader, size_t *len)
+{
+    while (true)
+    {
+        char *line = reader->buf + reader->start;
+        char *nl = memchr(line, '\n', reader->end - reader->start);
+
+        if (nl)
+        {
+            *nl = '\0';
+            *len = nl - line;
+
+            reader->start = (nl - reader->buf) + 1;
+
+            if (reader->skip)
+            {
+                reader->skip = false;
+
+                continue;
+            }
+
+            return line;
+        }
+
+        if (reader->eof)
+        {
+            // Última línea sin salto de línea al final
+            if ((reader->start < reader->end) && !reader->skip)
+            {
+                reader->buf[reader->end] = '\0';
+
+                *len = reader->end - reader->start;
+
+                reader->start = reader->end;
+
+                return line;
+            }
+
+            return NULL;
+        }
+
+        // Movemos la línea incompleta al comienzo del buffer
+        if (reader->start > 0)
+        {
+            memmove(reader->buf, line, reader->end - reader->start);
+
+            reader->end -= reader->start;
+            reader->start = 0;
+        }
+
+        if ((reader->end == reader->cap) && !reader->skip && (reader->cap < reader->max))
+        {
+            size_t cap = reader->cap * 2;
+
+            if (cap > reader->max)
+                cap = reader->max;
+
+            char *buf = (char *)realloc(reader->buf, cap + 1);
+
+            if (!buf)
+                show_err("Could not allocate memory for line reader buffer", _FATAL_ERR_);
+
+            reader->buf = buf;
+            reader->cap = cap;
+        }
+        else if (reader->end == reader->cap)
+        {
+            if (!reader->skip)
+                show_err("Input line too long", _NORM_ERR_);
+
+            reader->start = reader->end = 0;
+            reader->skip = true;
+        }
+
+        ssize_t n = read(reader->fd, reader->buf + reader->end, reader->cap - reader->end);
+
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            show_err("Could not read input", _FATAL_ERR_);
+        }
+
+        if (n == 0)
+            reader->eof = true;
+        else
+            reader->end += n;
+    }
+}
@@ -0,0 +1,772 @@
+/**
+ * @file parser.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con el analizador léxico y sintáctico
+ *        de las líneas de comandos de la shell.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/parser.h"
+
+/**
+ * @brief Esta función indica si un caracter separa palabras.
+ *
+ * @param c Caracter a analizar.
+ *
+ * @returns Si el caracter es un espacio o un operador.
+ */
+static bool is_separator(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') ||
+           (c == '|') || (c == '<') || (c == '>') || (c == '&') || (c == '\0');
+}
+
+/**
+ * @brief Esta función indica si un caracter puede formar parte
+ *        del nombre de una variable.
+ *
+ * @param c Caracter a analizar.
+ *
+ * @returns Si el caracter es alfanumérico o '_'.
+ */
+static bool is_name_char(char c)
+{
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+           ((c >= '0') && (c <= '9')) || (c == '_');
+}
+
+/**
+ * @brief Esta función obtiene las flags de 'open' con las que una
+ *        redirección debe abrir su archivo.
+ *
+ * @details '>' trunca el archivo y '>>' agrega al final con O_APPEND,
+ *          de modo que cada escritura se hace atómicamente al final del
+ *          archivo aunque varios procesos lo compartan. No se utiliza
+ *          O_CLOEXEC, ya que el archivo se abre directamente en el file
+ *          descriptor que hereda el programa (ver launch_prog).
+ *
+ * @param type Tipo de token de la redirección.
+ *
+ * @returns Las flags de 'open', o -1 si la redirección duplica un
+ *          file descriptor.
+ */
+static int redir_flags(int type)
+{
+    switch (type)
+    {
+        case _TOK_LT_:
+            return O_RDONLY;
+
+        case _TOK_GT_:
+            return O_WRONLY | O_CREAT | O_TRUNC;
+
+        case _TOK_GTGT_:
+            return O_WRONLY | O_CREAT | O_APPEND;
+
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Esta función arma el mensaje de error de una redirección
+ *        sin archivo.
+ *
+ * @param fd File descriptor de la redirección.
+ *
+ * @returns El mensaje de error.
+ */
+static char *redir_error(int fd)
+{
+    if (fd == STDIN_FILENO)
+        return "Invalid STDIN redirection input";
+
+    if (fd == STDOUT_FILENO)
+        return "Invalid STDOUT redirection input";
+
+    return "Invalid redirection input";
+}
+
+/**
+ * @brief Esta función toma el argumento de un prefijo de la línea
+ *        (por ejemplo, el tamaño de 'pipesize N') y descarta las
+ *        palabras del prefijo.
+ *
+ * @param tokens Tokens de la línea, a partir del prefijo (se avanza).
+ * @param amount Cantidad de tokens (se actualiza).
+ * @param pos Posición del argumento dentro del prefijo.
+ * @param arg Donde se guarda el argumento, sin expandir.
+ *
+ * @returns Si el prefijo tiene su argumento.
+ */
+static bool prefix_arg(token **tokens, int *amount, int pos, char **arg)
+{
+    if ((pos >= *amount) || ((*tokens)[pos].type != _TOK_WORD_))
+        return false;
+
+    *arg = (*tokens)[pos].word;
+
+    *tokens += pos + 1;
+    *amount -= pos + 1;
+
+    return true;
+}
+
+/**
+ * @brief Esta función indica si una palabra puede ser el ajuste de
+ *        prioridad del prefijo 'nice'.
+ *
+ * @param word Palabra sin expandir.
+ *
+ * @returns Si es un número entero (con o sin signo) o tiene variables,
+ *          que recién se validan al expandirlas.
+ */
+static bool prefix_number(char *word)
+{
+    if (strchr(word, _VAR_MARK_))
+        return true;
+
+    if ((*word == '-') || (*word == '+'))
+        word++;
+
+    if (*word == '\0')
+        return false;
+
+    for (; *word; word++)
+        if ((*word < '0') || (*word > '9'))
+            return false;
+
+    return true;
+}
+
+/**
+ * @brief Esta función indica si una palabra puede ser el conjunto de
+ *        CPUs del prefijo 'taskset'.
+ *
+ * @param word Palabra sin expandir.
+ * @param list Si se espera una lista en lugar de una máscara.
+ *
+ * @returns Si tiene la forma de una máscara hexadecimal (con o sin "0x")
+ *          o de una lista de CPUs y rangos, o tiene variables, que
+ *          recién se validan al expandirlas.
+ */
+static bool prefix_cpus(char *word, bool list)
+{
+    if (strchr(word, _VAR_MARK_))
+        return true;
+
+    char *digits = list ? "0123456789,-" : "0123456789abcdefABCDEF";
+
+    if (!list && (word[0] == '0') && ((word[1] == 'x') || (word[1] == 'X')))
+        word += 2;
+
+    return (*word != '\0') && (strspn(word, digits) == strlen(word));
+}
+
+/**
+ * @brief Esta función identifica los comandos internos de la shell.
+ *
+ * @details Se utiliza una tabla de hashing perfecta: la función de hash
+ *          (a partir del largo y de los dos primeros caracteres del
+ *          nombre) no tiene colisiones entre los comandos internos, por
+ *          lo que cada nombre se compara con una única entrada. Al
+ *          agregar un comando interno debe verificarse que su posición
+ *          esté libre (o buscar otros coeficientes para la función).
+ *
+ * @param name Nombre del comando.
+ *
+ * @returns El identificador del comando interno, o _BI_NONE_ si
+ *          se trata de un programa externo.
+ */
+int builtin_id(char *name)
+{
+    static const struct
+    {
+        char *name;
+
+        int id;
+    } builtins[_BI_TABLE_SIZE_] = {
+        [0] = { "quit", _BI_QUIT_ },
+        [1] = { "bg", _BI_BG_ },
+        [5] = { "fg", _BI_FG_ },
+        [6] = { "pwd", _BI_PWD_ },
+        [9] = { "exec", _BI_EXEC_ },
+        [10] = { "sleep", _BI_SLEEP_ },
+        [11] = { "set", _BI_SET_ },
+        [12] = { "tee", _BI_TEE_ },
+        [15] = { "jobs", _BI_JOBS_ },
+        [19] = { "test", _BI_TEST_ },
+        [23] = { "export", _BI_EXPORT_ },
+        [25] = { "forall", _BI_FORALL_ },
+        [26] = { "unset", _BI_UNSET_ },
+        [31] = { "rehash", _BI_REHASH_ },
+        [34] = { "[", _BI_TEST_ },
+        [38] = { "kill", _BI_KILL_ },
+        [43] = { "hash", _BI_HASH_ },
+        [44] = { "clr", _BI_CLR_ },
+        [45] = { "cd", _BI_CD_ },
+        [46] = { "true", _BI_TRUE_ },
+        [48] = { "false", _BI_FALSE_ },
+        [53] = { "shstat", _BI_SHSTAT_ },
+        [54] = { "echo", _BI_ECHO_ },
+        [56] = { "printf", _BI_PRINTF_ },
+        [58] = { "wait", _BI_WAIT_ }
+    };
+
+    size_t len = strnlen(name, _BI_MAX_LEN_ + 1);
+
+    if ((len == 0) || (len > _BI_MAX_LEN_))
+        return _BI_NONE_;
+
+    // name[1] es el '\0' final en los nombres de un caracter
+    size_t h = ((unsigned char)name[0] + (7 * ((unsigned char)name[1] + len))) & (_BI_TABLE_SIZE_ - 1);
+
+    if (builtins[h].name && (strcmp(name, builtins[h].name) == 0))
+        return builtins[h].id;
+
+    return _BI_NONE_;
+}
+
+/**
+ * @brief Esta función divide una línea en tokens en una única pasada.
+ *
+ * @details Se reconocen palabras y los operadores '|', '&' y los de
+ *          redirección ('<', '>', '>>', '<&' y '>&'), que pueden estar
+ *          precedidos por el número del file descriptor a redirigir
+ *          (por ejemplo, '2>' o '2>&1').
+ *          Dentro de una palabra, las comillas simples conservan todo
+ *          su contenido de manera literal, las comillas dobles permiten
+ *          escapar '"', '\' y '$' con '\', y fuera de las comillas '\'
+ *          escapa cualquier caracter. Un '#' al comienzo de una palabra
+ *          inicia un comentario hasta el final de la línea.
+ *          Las palabras se escriben ya sin comillas en el buffer words,
+ *          separadas por '\0', y cada '$' a expandir se reemplaza por
+ *          _VAR_MARK_. La línea original no se modifica.
+ *
+ * @param line Línea a analizar.
+ * @param tokens Donde se guardan los tokens (al menos strlen(line) + 1).
+ * @param words Donde se guardan las palabras (al menos 2 * strlen(line) + 1).
+ *
+ * @returns La cantidad de tokens, o -1 si hay comillas sin cerrar.
+ */
+int lex_line(char *line, token *tokens, char *words)
+{
+    int amount = 0;
+
+    char *c = line;
+
+    while (true)
+    {
+        while ((*c == ' ') || (*c == '\t') || (*c == '\n') || (*c == '\r'))
+            c++;
+
+        if ((*c == '\0') || (*c == '#'))
+            return amount;
+
+        // Número de file descriptor pegado a una redirección (2>, 2>&1, 0<...)
+        int fd = -1;
+
+        char *digits = c;
+
+        while ((*digits >= '0') && (*digits <= '9') && (digits - c < _FD_MAX_DIGITS_))
+            digits++;
+
+        if ((digits > c) && ((*digits == '<') || (*digits == '>')))
+        {
+            fd = (int)strtol(c, NULL, 10);
+
+            c = digits;
+        }
+
+        switch (*c)
+        {
+            case '|':
+            {
+                tokens[amount++].type = _TOK_PIPE_;
+                c++;
+
+                continue;
+            }
+
+            case '<':
+            {
+                tokens[amount].type = (c[1] == '&') ? _TOK_DUP_ : _TOK_LT_;
+                tokens[amount++].fd = (fd == -1) ? STDIN_FILENO : fd;
+                c += 1 + (c[1] == '&');
+
+                continue;
+            }
+
+            case '>':
+            {
+                tokens[amount].type = (c[1] == '>') ? _TOK_GTGT_ : ((c[1] == '&') ? _TOK_DUP_ : _TOK_GT_);
+                tokens[amount++].fd = (fd == -1) ? STDOUT_FILENO : fd;
+                c += 1 + ((c[1] == '>') || (c[1] == '&'));
+
+                continue;
+            }
+
+            case '&':
+            {
+                tokens[amount++].type = _TOK_AMP_;
+                c++;
+
+                continue;
+            }
+        }
+
+        tokens[amount].type = _TOK_WORD_;
+        tokens[amount].word = words;
+
+        amount++;
+
+        while (!is_separator(*c))
+        {
+            if (*c == '\'')
+            {
+                char *end = strchr(c + 1, '\'');
+
+                if (!end)
+                    return -1;
+
+                memcpy(words, c + 1, end - c - 1);
+
+                words += end - c - 1;
+                c = end + 1;
+            }
+            else if (*c == '"')
+            {
+                for (c++; *c != '"'; c++)
+                {
+                    if (*c == '\0')
+                        return -1;
+
+                    if ((*c == '\\') && ((c[1] == '"') || (c[1] == '\\') || (c[1] == '$')))
+                        *words++ = *++c;
+                    else if (*c == '$')
+                        *words++ = _VAR_MARK_;
+                    else if (*c != _VAR_MARK_)
+                        *words++ = *c;
+                }
+
+                c++;
+            }
+            else if (*c == '\\')
+            {
+                if (c[1] != '\0')
+                    c++;
+
+                *words++ = *c++;
+            }
+            else if (*c == '$')
+            {
+                *words++ = _VAR_MARK_;
+                c++;
+            }
+            else if (*c == _VAR_MARK_)
+                c++;
+            else
+                *words++ = *c++;
+        }
+
+        *words++ = '\0';
+    }
+}
+
+/**
+ * @brief Esta función obtiene el valor de la variable que comienza
+ *        en una marca de expansión.
+ *
+ * @param c Posición de la marca. Se avanza hasta después de la variable.
+ * @param status Buffer donde se escribe el valor de $?.
+ * @param len Donde se guarda el largo del valor.
+ *
+ * @returns El valor de la variable (sin terminar en '\0').
+ */
+static char *var_value(char **c, char *status, size_t *len)
+{
+    char name[_STR_MAX_LEN_];
+
+    char *start = *c + 1;
+    char *end = start;
+
+    bool braces = (*start == '{');
+
+    if (braces)
+        end = ++start;
+
+    while (is_name_char(*end))
+        end++;
+
+    if (braces && (*end != '}'))
+        end = start;
+
+    if ((end == start) && (*start == '?'))
+    {
+        *len = sprintf(status, "%d", last_status);
+        *c = start + 1;
+
+        return status;
+    }
+
+    if ((end == start) || ((size_t)(end - start) >= sizeof(name)))
+    {
+        // No hay un nombre válido: se conserva el '$'
+        *len = 1;
+        *c = *c + 1;
+
+        return "$";
+    }
+
+    memcpy(name, start, end - start);
+
+    name[end - start] = '\0';
+
+    char *value = var_get(name);
+
+    *len = value ? strlen(value) : 0;
+    *c = end + braces;
+
+    return value ? value : "";
+}
+
+/**
+ * @brief Esta función expande las variables de una palabra.
+ *
+ * @details Se reemplaza cada $NOMBRE o ${NOMBRE} por el valor de la
+ *          variable de la shell o de entorno correspondiente (vacío si
+ *          no existe) y $? por el código de salida del último comando.
+ *          Un '$' que no precede a un nombre válido se conserva.
+ *          Se recorre la palabra dos veces: una para calcular el largo
+ *          del resultado y otra para escribirlo, de modo que se lo
+ *          reserva de la arena con un único pedido.
+ *          Si la palabra no tiene nada para expandir se la devuelve
+ *          tal cual, sin copiarla.
+ *
+ * @param a Arena de la que se reserva la palabra expandida.
+ * @param word Palabra a expandir (tal como la dejó lex_line).
+ *
+ * @returns La palabra expandida.
+ */
+char *expand_word(arena *a, char *word)
+{
+    if (!strchr(word, _VAR_MARK_))
+        return word;
+
+    char status[16];
+
+    size_t len = 0;
+    size_t value_len;
+
+    for (char *c = word; *c; )
+        if (*c != _VAR_MARK_)
+        {
+            len++;
+            c++;
+        }
+        else
+        {
+            var_value(&c, status, &value_len);
+
+            len += value_len;
+        }
+
+    char *result = (char *)arena_alloc(a, len + 1);
+    char *out = result;
+
+    for (char *c = word; *c; )
+        if (*c != _VAR_MARK_)
+            *out++ = *c++;
+        else
+        {
+            char *value = var_value(&c, status, &value_len);
+
+            memcpy(out, value, value_len);
+
+            out += value_len;
+        }
+
+    *out = '\0';
+
+    return result;
+}
+
+/**
+ * @brief Esta función analiza una línea de comandos y arma su
+ *        árbol sintáctico.
+ *
+ * @details Se divide la línea en tokens con lex_line y se los recorre
+ *          una única vez armando las etapas del comando. Cada etapa
+ *          tiene sus palabras y sus redirecciones, que pueden aparecer
+ *          en cualquier orden. Las redirecciones quedan planificadas
+ *          (file descriptor, flags de 'open' y archivo) para aplicarlas
+ *          en orden al lanzar cada etapa. Un '&' sólo puede estar al
+ *          final, y la palabra clave 'time' sólo al comienzo.
+ *          El árbol resultante se ejecuta sin volver a analizar la línea.
+ *
+ * @param a Arena de la que se reserva toda la memoria del árbol.
+ * @param line Línea a analizar.
+ * @param err Donde se guarda el mensaje del error de sintaxis, si lo hay.
+ *
+ * @returns La línea analizada, válida hasta que se reinicie la arena,
+ *          o NULL si tiene errores de sintaxis.
+ */
+pipeline *parse_line(arena *a, char *line, char **err)
+{
+    size_t len = strlen(line);
+
+    pipeline *pl = (pipeline *)arena_calloc(a, 1, sizeof(pipeline));
+    token *tokens = (token *)arena_alloc(a, (len + 1) * sizeof(token));
+
+    pl->text = arena_strdup(a, line);
+
+    int tokens_amount = lex_line(line, tokens, (char *)arena_alloc(a, (len * 2) + 1));
+
+    if (tokens_amount == -1)
+    {
+        *err = "Invalid input - unterminated quoted string";
+
+        return NULL;
+    }
+
+    *err = NULL;
+
+    /*
+        Prefijos de la línea, en cualquier orden:
+        - 'time': se miden los recursos consumidos por la línea.
+        - 'pipesize N': capacidad de los pipes de la línea.
+        - 'taskset [-c] [-s] CPUS': CPUs en las que se ejecuta.
+        - 'nice [-n N | -N | N]': ajuste de la prioridad de sus procesos
+          (10 si no se indica, y '-N' suma N, como en nice(1)).
+        - 'limit RECURSO=valor,...': límites de recursos de sus procesos.
+        'taskset' y 'nice' sólo son prefijos si sus argumentos tienen esa
+        forma y les sigue un comando; si no, quedan como nombre del
+        comando para ejecutar los programas homónimos.
+    */
+    while ((tokens_amount > 0) && (tokens[0].type == _TOK_WORD_) && !*err)
+    {
+        char *word = tokens[0].word;
+
+        int flags = 1; // Palabras del prefijo antes de su argumento
+
+        if (!pl->timed && (strcmp(word, "time") == 0))
+        {
+            pl->timed = true;
+
+            tokens++;
+            tokens_amount--;
+        }
+        else if (!pl->pipe_size && (strcmp(word, "pipesize") == 0))
+        {
+            if (!prefix_arg(&tokens, &tokens_amount, 1, &pl->pipe_size))
+                *err = "Invalid pipesize prefix - expected a size";
+        }
+        else if (!pl->cpus && (strcmp(word, "taskset") == 0))
+        {
+            bool list = false;
+            bool spread = false;
+
+            for (; (flags < tokens_amount) && (tokens[flags].type == _TOK_WORD_); flags++)
+                if (strcmp(tokens[flags].word, "-c") == 0)
+                    list = true;
+                else if (strcmp(tokens[flags].word, "-s") == 0)
+                    spread = true;
+                else
+                    break;
+
+            if ((flags + 1 >= tokens_amount) || (tokens[flags].type != _TOK_WORD_) ||
+                !prefix_cpus(tokens[flags].word, list))
+                break;
+
+            pl->cpus_list = list;
+            pl->spread = spread;
+
+            prefix_arg(&tokens, &tokens_amount, flags, &pl->cpus);
+        }
+        else if (!pl->niceness && (strcmp(word, "nice") == 0))
+        {
+            char *arg = ((tokens_amount > 1) && (tokens[1].type == _TOK_WORD_)) ? tokens[1].word : NULL;
+
+            if (!arg)
+                break;
+
+            if (strcmp(arg, "-n") == 0)
+            {
+                if ((tokens_amount < 4) || (tokens[2].type != _TOK_WORD_) || !prefix_number(tokens[2].word))
+                    break;
+
+                prefix_arg(&tokens, &tokens_amount, 2, &pl->niceness);
+            }
+            else if (prefix_number(arg) && (arg[0] != '-'))
+            {
+                if (tokens_amount < 3)
+                    break;
+
+                prefix_arg(&tokens, &tokens_amount, 1, &pl->niceness);
+            }
+            else if ((arg[0] == '-') && prefix_number(arg + 1))
+            {
+                if (tokens_amount < 3)
+                    break;
+
+                // Como en nice(1), '-N' es un ajuste de +N
+                prefix_arg(&tokens, &tokens_amount, 1, &pl->niceness);
+
+                pl->niceness++;
+            }
+            else if (arg[0] != '-')
+            {
+                pl->niceness = "10";
+
+                tokens++;
+                tokens_amount--;
+            }
+            else
+                break;
+        }
+        else if (!pl->limits && (strcmp(word, "limit") == 0))
+        {
+            if (!prefix_arg(&tokens, &tokens_amount, 1, &pl->limits))
+                *err = "Invalid limit prefix - expected resource limits";
+        }
+        else
+            break;
+    }
+
+    if (*err)
+        return NULL;
+
+    if ((tokens_amount > 0) && (tokens[tokens_amount - 1].type == _TOK_AMP_))
+    {
+        pl->bg = true;
+
+        tokens_amount--;
+    }
+
+    if (tokens_amount == 0)
+    {
+        if (pl->bg)
+        {
+            *err = "Invalid background execution command";
+
+            return NULL;
+        }
+
+        return pl; // Línea vacía o sólo con comentarios
+    }
+
+    pl->cmds_amount = 1;
+
+    int redirs_amount = 0;
+
+    for (int i = 0; i < tokens_amount; i++)
+        if (tokens[i].type == _TOK_PIPE_)
+            pl->cmds_amount++;
+        else if (tokens[i].type != _TOK_WORD_)
+            redirs_amount++;
+
+    // Cada etapa necesita un lugar más por el NULL final de su argv
+    pl->cmds = (command *)arena_calloc(a, pl->cmds_amount, sizeof(command));
+
+    char **next_arg = (char **)arena_alloc(a, (tokens_amount + pl->cmds_amount) * sizeof(char *));
+
+    // Las redirecciones de todas las etapas se guardan en un único arreglo
+    redir *next_redir = redirs_amount ? (redir *)arena_alloc(a, redirs_amount * sizeof(redir)) : NULL;
+
+    command *cmd = &pl->cmds[0];
+
+    cmd->argv = next_arg;
+    cmd->redirs = next_redir;
+
+    for (int i = 0; (i <= tokens_amount) && !*err; i++)
+    {
+        if ((i == tokens_amount) || (tokens[i].type == _TOK_PIPE_))
+        {
+            if (cmd->argc == 0)
+            {
+                *err = "Invalid pipeline - empty command";
+
+                break;
+            }
+
+            *next_arg++ = NULL;
+
+            char *eq = strchr(cmd->argv[0], '=');
+
+            // Una única palabra NOMBRE=valor es una asignación
+            if ((cmd->argc == 1) && eq && is_var_name(cmd->argv[0], eq - cmd->argv[0]))
+                cmd->builtin = _BI_ASSIGN_;
+            else
+                cmd->builtin = strchr(cmd->argv[0], _VAR_MARK_) ? _BI_EXPAND_ : builtin_id(cmd->argv[0]);
+
+            if (i < tokens_amount)
+            {
+                cmd++;
+
+                cmd->argv = next_arg;
+                cmd->redirs = next_redir;
+            }
+
+            continue;
+        }
+
+        switch (tokens[i].type)
+        {
+            case _TOK_WORD_:
+            {
+                *next_arg++ = tokens[i].word;
+
+                cmd->argc++;
+
+                break;
+            }
+
+            case _TOK_LT_:
+            case _TOK_GT_:
+            case _TOK_GTGT_:
+            case _TOK_DUP_:
+            {
+                if ((i + 1 == tokens_amount) || (tokens[i + 1].type != _TOK_WORD_))
+                {
+                    *err = redir_error(tokens[i].fd);
+
+                    break;
+                }
+
+                redir *r = next_redir++;
+
+                r->fd = tokens[i].fd;
+                r->flags = redir_flags(tokens[i].type);
+                r->dup_fd = -1;
+                r->file = tokens[++i].word;
+
+                cmd->redirs_amount++;
+
+                if (tokens[i - 1].type == _TOK_DUP_)
+                {
+                    char *end;
+
+                    long dup_fd = strtol(r->file, &end, 10);
+
+                    if ((end == r->file) || (*end != '\0') || (dup_fd < 0) || (dup_fd > INT_MAX))
+                        *err = "Invalid redirection - expected a file descriptor number";
+
+                    r->dup_fd = (int)dup_fd;
+                    r->file = NULL;
+                }
+
+                break;
+            }
+
+            default:
+            {
+                *err = "Invalid background execution command";
+
+                break;
+            }
+        }
+    }
+
+    return *err ? NULL : pl;
+}
@@ -0,0 +1,273 @@
+/**
+ * @file path_hash.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con la tabla de hashing que almacena la
+ *        ubicación de los programas estándar encontrados
+ *        en los directorios de $PATH.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/path_hash.h"
+
+/**
+ * @brief Esta función calcula el hash FNV-1a de un string.
+ *
+ * @param str String a hashear.
+ *
+ * @returns El hash del string.
+ */
+static unsigned long hash_str(char *str)
+{
+    unsigned long hash = 14695981039346656037UL;
+
+    while (*str)
+    {
+        hash ^= (unsigned char)*str++;
+        hash *= 1099511628211UL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Esta función busca la posición de un nombre en la tabla.
+ *
+ * @details Se utiliza direccionamiento abierto con sondeo lineal,
+ *          por lo que se devuelve la posición donde está el nombre
+ *          o la primera posición libre donde debería insertarse.
+ *
+ * @param table Tabla en la que se busca.
+ * @param size Tamaño de la tabla (potencia de 2).
+ * @param name Nombre del programa a buscar.
+ *
+ * @returns La entrada correspondiente al nombre.
+ */
+static hash_entry *hash_slot(hash_entry *table, size_t size, char *name)
+{
+    size_t i = hash_str(name) & (size - 1);
+
+    while (table[i].name && (strcmp(table[i].name, name) != 0))
+        i = (i + 1) & (size - 1);
+
+    return &table[i];
+}
+
+/**
+ * @brief Esta función duplica el tamaño de la tabla, reubicando
+ *        las entradas existentes.
+ */
+static void hash_grow(void)
+{
+    size_t new_size = hash_size ? (hash_size * 2) : _HASH_INIT_SIZE_;
+
+    hash_entry *new_table = (hash_entry *)calloc(new_size, sizeof(hash_entry));
+
+    if (!new_table)
+        show_err("Could not allocate memory for command hash table", _FATAL_ERR_);
+
+    for (size_t i = 0; i < hash_size; i++)
+        if (hash_table[i].name)
+            *hash_slot(new_table, new_size, hash_table[i].name) = hash_table[i];
+
+    free(hash_table);
+
+    hash_table = new_table;
+    hash_size = new_size;
+}
+
+/**
+ * @brief Esta función busca un programa en los directorios de $PATH.
+ *
+ * @details Se recorren los directorios en orden y se devuelve el primer
+ *          archivo regular con permisos de ejecución. De esta manera,
+ *          el child process no tiene que probar con 'execv' cada uno de
+ *          los directorios de $PATH.
+ *
+ * @param name Nombre del programa a buscar.
+ * @param path Valor de $PATH.
+ * @param cacheable Se indica si el resultado puede guardarse en la tabla
+ *                  (no puede si se encontró en un directorio relativo).
+ *
+ * @returns El path absoluto del programa, o NULL si no se encontró.
+ */
+static char *path_search(char *name, char *path, bool *cacheable)
+{
+    char candidate[PATH_MAX];
+
+    struct stat st;
+
+    size_t name_len = strlen(name);
+
+    *cacheable = true;
+
+    while (true)
+    {
+        char *end = strchrnul(path, ':');
+
+        size_t dir_len = end - path;
+
+        // Un directorio vacío en $PATH hace referencia al directorio actual
+        if (dir_len == 0)
+        {
+            path = ".";
+            dir_len = 1;
+        }
+
+        if (dir_len + name_len + 2 <= sizeof(candidate))
+        {
+            memcpy(candidate, path, dir_len);
+
+            candidate[dir_len] = '/';
+
+            memcpy(candidate + dir_len + 1, name, name_len + 1);
+
+            if ((stat(candidate, &st) == 0) && S_ISREG(st.st_mode) && (access(candidate, X_OK) == 0))
+            {
+                *cacheable = (candidate[0] == '/');
+
+                char *found = strdup(candidate);
+
+                if (!found)
+                    show_err("Could not allocate memory for command path", _FATAL_ERR_);
+
+                return found;
+            }
+        }
+
+        if (*end == '\0')
+            return NULL;
+
+        path = end + 1;
+    }
+}
+
+/**
+ * @brief Esta función vacía la tabla de hashing de comandos.
+ *
+ * @details Se utiliza con los comandos 'hash -r' y 'rehash', y
+ *          automáticamente cuando cambia el valor de $PATH.
+ */
+void hash_reset(void)
+{
+    for (size_t i = 0; i < hash_size; i++)
+        if (hash_table[i].name)
+        {
+            free(hash_table[i].name);
+            free(hash_table[i].path);
+        }
+
+    free(hash_table);
+    free(hash_path);
+
+    hash_table = NULL;
+    hash_path = NULL;
+    hash_size = 0;
+    hash_used = 0;
+}
+
+/**
+ * @brief Esta función muestra en pantalla el contenido de la
+ *        tabla de hashing con la cantidad de usos de cada entrada.
+ */
+void hash_show(void)
+{
+    if (hash_used == 0)
+    {
+        out_write("hash: hash table empty\n");
+
+        return;
+    }
+
+    out_write("hits\tcommand\n");
+
+    for (size_t i = 0; i < hash_size; i++)
+        if (hash_table[i].name)
+        {
+            char line[PATH_MAX + 32];
+
+            snprintf(line, sizeof(line), "%4lu\t%s\n", hash_table[i].hits, hash_table[i].path);
+
+            out_write(line);
+        }
+}
+
+/**
+ * @brief Esta función devuelve el path absoluto de un programa
+ *        estándar, resolviéndolo mediante $PATH sólo la primera
+ *        vez que se lo solicita.
+ *
+ * @details Si $PATH cambió desde que se llenó la tabla, se la vacía
+ *          antes de buscar. El string devuelto pertenece a la tabla,
+ *          por lo que no debe liberarse y sólo es válido hasta el
+ *          próximo vaciado de la misma.
+ *
+ * @param name Nombre del programa a buscar.
+ *
+ * @returns El path absoluto del programa, o NULL si no se encontró.
+ */
+char *hash_lookup(char *name)
+{
+    char *path = getenv("PATH");
+
+    if (!path)
+        return NULL;
+
+    if (!hash_path || (strcmp(hash_path, path) != 0))
+    {
+        hash_reset();
+
+        hash_path = strdup(path);
+
+        if (!hash_path)
+            show_err("Could not allocate memory for command hash table", _FATAL_ERR_);
+    }
+
+    if (hash_size)
+    {
+        hash_entry *entry = hash_slot(hash_table, hash_size, name);
+
+        if (entry->name)
+        {
+            entry->hits++;
+
+            return entry->path;
+        }
+    }
+
+    bool cacheable;
+
+    char *found = path_search(name, path, &cacheable);
+
+    if (!found)
+        return NULL;
+
+    if (!cacheable)
+    {
+        // No se guarda en la tabla pero tampoco debe perderse la memoria
+        static char *uncached = NULL;
+
+        free(uncached);
+
+        uncached = found;
+
+        return found;
+    }
+
+    // Mantenemos el factor de carga por debajo de 1/2
+    if ((hash_used + 1) * 2 > hash_size)
+        hash_grow();
+
+    hash_entry *entry = hash_slot(hash_table, hash_size, name);
+
+    entry->name = strdup(name);
+    entry->path = found;
+    entry->hits = 1;
+
+    if (!entry->name)
+        show_err("Could not allocate memory for command hash table", _FATAL_ERR_);
+
+    hash_used++;
+
+    return found;
+}
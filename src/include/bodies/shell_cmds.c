@@ -10,510 +10,2546 @@
 
 #include "../headers/shell_cmds.h"
 
+static pid_t *inline_pids = NULL; // Procesos del comando cuya etapa se ejecuta en la shell
+
+static volatile sig_atomic_t inline_pids_amount = 0;
+
+/**
+ * @brief Esta función expande las variables de los argumentos
+ *        de una etapa.
+ *
+ * @param cmd Etapa a expandir.
+ *
+ * @returns Los argumentos expandidos, reservados de cmd_arena. Si
+ *          ninguno tenía variables, se devuelve directamente el argv
+ *          de la etapa, sin copiarlo.
+ */
+static char **expand_args(command *cmd)
+{
+    int i = 0;
+
+    while (cmd->argv[i] && !strchr(cmd->argv[i], _VAR_MARK_))
+        i++;
+
+    if (!cmd->argv[i])
+        return cmd->argv;
+
+    char **args = (char **)arena_alloc(&cmd_arena, (cmd->argc + 1) * sizeof(char *));
+
+    for (i = 0; i < cmd->argc; i++)
+        args[i] = expand_word(&cmd_arena, cmd->argv[i]);
+
+    args[cmd->argc] = NULL;
+
+    return args;
+}
+
+/**
+ * @brief Esta función expande los archivos de las redirecciones de
+ *        una etapa del árbol sintáctico.
+ *
+ * @details Los paths relativos se abren desde el directorio actual, por
+ *          lo que no hace falta armar el path completo. Si ningún archivo
+ *          tiene variables, se utilizan las redirecciones del árbol tal
+ *          cual, sin copiarlas.
+ *
+ * @param cmd Etapa del árbol sintáctico.
+ *
+ * @returns Las redirecciones expandidas (reservadas de cmd_arena si
+ *          hizo falta copiarlas).
+ */
+static redir *redirs_expand(command *cmd)
+{
+    int i = 0;
+
+    while ((i < cmd->redirs_amount) && !(cmd->redirs[i].file && strchr(cmd->redirs[i].file, _VAR_MARK_)))
+        i++;
+
+    if (i == cmd->redirs_amount)
+        return cmd->redirs;
+
+    redir *redirs = (redir *)arena_alloc(&cmd_arena, cmd->redirs_amount * sizeof(redir));
+
+    for (i = 0; i < cmd->redirs_amount; i++)
+    {
+        redirs[i] = cmd->redirs[i];
+
+        if (redirs[i].file)
+            redirs[i].file = expand_word(&cmd_arena, redirs[i].file);
+    }
+
+    return redirs;
+}
+
+/**
+ * @brief Esta función indica si una etapa redirige un file descriptor.
+ *
+ * @param st Etapa a analizar.
+ * @param fd File descriptor.
+ *
+ * @returns Si alguna redirección de la etapa reemplaza a fd.
+ */
+static bool stage_redirects(stage *st, int fd)
+{
+    for (int i = 0; i < st->redirs_amount; i++)
+        if (st->redirs[i].fd == fd)
+            return true;
+
+    return false;
+}
+
+/**
+ * @brief Esta función restaura los file descriptors reemplazados
+ *        por redirs_apply.
+ *
+ * @details Se recorren las redirecciones en el orden inverso, para que
+ *          un mismo file descriptor redirigido varias veces recupere su
+ *          valor original.
+ *
+ * @param redirs Redirecciones aplicadas.
+ * @param amount Cantidad de redirecciones.
+ * @param saved Copias guardadas por redirs_apply.
+ */
+static void redirs_restore(redir *redirs, int amount, int *saved)
+{
+    out_flush();
+
+    for (int i = amount - 1; i >= 0; i--)
+    {
+        if (saved[i] == -1)
+        {
+            close(redirs[i].fd);
+
+            continue;
+        }
+
+        if (dup2(saved[i], redirs[i].fd) == -1)
+            show_err("Could not restore a redirected file descriptor", _FATAL_ERR_);
+
+        close(saved[i]);
+    }
+}
+
+/**
+ * @brief Esta función aplica en orden redirecciones al proceso actual.
+ *
+ * @details Cada archivo se abre con las flags planificadas por el
+ *          parser y se lo duplica en el file descriptor correspondiente;
+ *          las redirecciones N>&M duplican directamente M en N. Como se
+ *          aplican en orden, '> archivo 2>&1' envía stdout y stderr al
+ *          archivo.
+ *          Si se indica saved, antes de cada redirección se guarda una
+ *          copia del file descriptor que se reemplaza (o -1 si estaba
+ *          cerrado), para restaurarlo con redirs_restore. Si alguna
+ *          redirección falla, se restauran las que ya se aplicaron.
+ *
+ * @param redirs Redirecciones a aplicar.
+ * @param amount Cantidad de redirecciones.
+ * @param saved Donde se guardan las copias (amount lugares), o NULL
+ *              si no hace falta restaurarlas (en los child processes).
+ *
+ * @returns Si se pudieron aplicar todas las redirecciones.
+ */
+static bool redirs_apply(redir *redirs, int amount, int *saved)
+{
+    char msg[_STR_MAX_LEN_];
+
+    out_flush();
+
+    for (int i = 0; i < amount; i++)
+    {
+        redir *r = &redirs[i];
+
+        if (saved)
+            saved[i] = fcntl(r->fd, F_DUPFD_CLOEXEC, _FD_SAVE_MIN_);
+
+        int src = r->file ? open(r->file, r->flags | O_CLOEXEC, 0666) : r->dup_fd;
+
+        if ((src == -1) || ((src != r->fd) && (dup2(src, r->fd) == -1)))
+        {
+            if (r->file && (src == -1))
+                snprintf(msg, sizeof(msg), "Could not open redirection file %s: %s", r->file, strerror(errno));
+            else
+                snprintf(msg, sizeof(msg), "Could not redirect file descriptor %d: %s", r->fd, strerror(errno));
+
+            if (r->file && (src != -1))
+                close(src);
+
+            if (saved)
+                redirs_restore(redirs, i + 1, saved);
+
+            show_err(msg, _NORM_ERR_);
+
+            return false;
+        }
+
+        if (r->file && (src != r->fd))
+            close(src);
+        else if (r->file)
+            fcntl(r->fd, F_SETFD, 0); // Se abrió justo en r->fd, que debe quedar sin O_CLOEXEC
+    }
+
+    return true;
+}
+
+/**
+ * @brief Esta función prepara una etapa del árbol sintáctico para
+ *        ejecutarla, sin volver a analizar la línea.
+ *
+ * @details Se expanden sus argumentos, se identifica si es un comando
+ *          interno (si su nombre dependía de una variable), se expanden
+ *          los archivos de sus redirecciones y se resuelve su programa.
+ *          Los nombres con '/' se ejecutan tal cual (relativos al
+ *          directorio actual si no son absolutos) y el resto se busca
+ *          en $PATH mediante la tabla de hashing de comandos, salvo que
+ *          la etapa ya traiga su programa resuelto.
+ *          Toda la memoria de la etapa se reserva de cmd_arena.
+ *
+ * @param cmd Etapa del árbol sintáctico.
+ * @param st Donde se guarda la etapa preparada.
+ *
+ * @returns Si la etapa puede ejecutarse.
+ */
+static bool stage_prepare(command *cmd, stage *st)
+{
+    st->args = expand_args(cmd);
+    st->builtin = (cmd->builtin == _BI_EXPAND_) ? builtin_id(st->args[0]) : cmd->builtin;
+
+    st->redirs = redirs_expand(cmd);
+    st->redirs_amount = cmd->redirs_amount;
+
+    if (st->builtin != _BI_NONE_)
+        return true;
+
+    char *path = cmd->path;
+
+    if (!path)
+        path = strchr(st->args[0], '/') ? st->args[0] : hash_lookup(st->args[0]);
+
+    if (!path || (st->args[0][0] == '\0'))
+    {
+        show_err("No such program found", _NORM_ERR_);
+
+        last_status = 127;
+
+        sh_stats.failed_execs++;
+
+        return false;
+    }
+
+    st->path = arena_strdup(&cmd_arena, path);
+
+    return true;
+}
+
+/**
+ * @brief Esta función indica si un comando interno puede ejecutarse
+ *        en una copia de la shell, como etapa de un pipe o en
+ *        background.
+ *
+ * @details Sólo se admiten los comandos que no modifican el estado de
+ *          la shell, ya que sus efectos se perderían con la copia.
+ *
+ * @param id Identificador del comando interno.
+ *
+ * @returns Si el comando puede ejecutarse en una copia de la shell.
+ */
+static bool builtin_forkable(int id)
+{
+    switch (id)
+    {
+        case _BI_ECHO_:
+        case _BI_FALSE_:
+        case _BI_FORALL_:
+        case _BI_KILL_:
+        case _BI_PRINTF_:
+        case _BI_PWD_:
+        case _BI_SLEEP_:
+        case _BI_TEE_:
+        case _BI_TEST_:
+        case _BI_TRUE_:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Esta función ejecuta un comando interno ya preparado.
+ *
+ * @details El comando 'quit' no se ejecuta aquí, sino en exec_line.
+ *
+ * @param st Etapa a ejecutar.
+ */
+static void run_builtin(stage *st)
+{
+    last_status = EXIT_SUCCESS;
+
+    sh_stats.builtins++;
+
+    switch (st->builtin)
+    {
+        case _BI_ASSIGN_:
+        {
+            cmd_assign(st->args);
+
+            break;
+        }
+
+        case _BI_CD_:
+        {
+            cmd_cd(st->args);
+
+            break;
+        }
+
+        case _BI_CLR_:
+        {
+            cmd_clr();
+
+            break;
+        }
+
+        case _BI_ECHO_:
+        {
+            cmd_echo(st->args, stage_redirects(st, STDIN_FILENO));
+
+            break;
+        }
+
+        case _BI_EXEC_:
+        {
+            cmd_replace(st->args);
+
+            break;
+        }
+
+        case _BI_EXPORT_:
+        {
+            cmd_export(st->args);
+
+            break;
+        }
+
+        case _BI_FALSE_:
+        {
+            last_status = EXIT_FAILURE;
+
+            break;
+        }
+
+        case _BI_FORALL_:
+        {
+            cmd_forall(st->args);
+
+            break;
+        }
+
+        case _BI_HASH_:
+        case _BI_REHASH_:
+        {
+            cmd_hash(st->args);
+
+            break;
+        }
+
+        case _BI_KILL_:
+        {
+            cmd_kill(st->args);
+
+            break;
+        }
+
+        case _BI_PRINTF_:
+        {
+            cmd_printf(st->args);
+
+            break;
+        }
+
+        case _BI_PWD_:
+        {
+            cmd_pwd();
+
+            break;
+        }
+
+        case _BI_SET_:
+        {
+            cmd_set(st->args);
+
+            break;
+        }
+
+        case _BI_SHSTAT_:
+        {
+            cmd_shstat(st->args);
+
+            break;
+        }
+
+        case _BI_SLEEP_:
+        {
+            cmd_sleep(st->args);
+
+            break;
+        }
+
+        case _BI_TEE_:
+        {
+            cmd_tee(st->args);
+
+            break;
+        }
+
+        case _BI_TEST_:
+        {
+            cmd_test(st->args);
+
+            break;
+        }
+
+        case _BI_TRUE_:
+        {
+            break;
+        }
+
+        case _BI_UNSET_:
+        {
+            cmd_unset(st->args);
+
+            break;
+        }
+
+        default:
+        {
+            cmd_jobs(st->args);
+
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Esta función ejecuta un comando interno precedido por 'time'
+ *        y muestra los recursos que consumió.
+ *
+ * @details El comando interno se ejecuta en el proceso de la shell,
+ *          por lo que sus recursos se obtienen como la diferencia del
+ *          consumo de la propia shell (RUSAGE_SELF) antes y después de
+ *          ejecutarlo. La memoria residente es el máximo de la shell.
+ *
+ * @param pl Línea a ejecutar.
+ * @param st Etapa a ejecutar.
+ */
+static void run_timed_builtin(pipeline *pl, stage *st)
+{
+    struct rusage before;
+
+    struct timespec start, end;
+
+    stage_time t;
+
+    getrusage(RUSAGE_SELF, &before);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    run_builtin(st);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    getrusage(RUSAGE_SELF, &t.usage);
+
+    timersub(&t.usage.ru_utime, &before.ru_utime, &t.usage.ru_utime);
+    timersub(&t.usage.ru_stime, &before.ru_stime, &t.usage.ru_stime);
+
+    t.usage.ru_nvcsw -= before.ru_nvcsw;
+    t.usage.ru_nivcsw -= before.ru_nivcsw;
+    t.usage.ru_majflt -= before.ru_majflt;
+    t.usage.ru_minflt -= before.ru_minflt;
+
+    t.name = st->args[0];
+    t.pid = getpid();
+    t.status = last_status;
+    t.real = ts_diff(&start, &end);
+
+    time_report(pl->text, &t, 1, t.real);
+}
+
+/**
+ * @brief Esta función aplica las redirecciones de un comando interno
+ *        a la shell, midiendo el tiempo que tarda.
+ *
+ * @param st Etapa a ejecutar.
+ * @param saved Donde se guardan los file descriptors reemplazados.
+ *
+ * @returns Si se pudieron aplicar todas las redirecciones.
+ */
+static bool timed_redirect(stage *st, int *saved)
+{
+    uint64_t start = stat_now();
+
+    bool ok = redirs_apply(st->redirs, st->redirs_amount, saved);
+
+    stat_phase(_PH_REDIR_, start);
+
+    return ok;
+}
+
+/**
+ * @brief Esta función interpreta una cantidad entera, con los sufijos
+ *        'K', 'M' o 'G' (potencias de 1024).
+ *
+ * @param str Cantidad a interpretar.
+ * @param value Donde se guarda la cantidad.
+ *
+ * @returns Si la cantidad es válida y no negativa.
+ */
+static bool amount_parse(char *str, long long *value)
+{
+    char *end;
+
+    errno = 0;
+
+    long long amount = strtoll(str, &end, 10);
+    long long unit = 1;
+
+    switch (*end)
+    {
+        case 'k':
+        case 'K':
+        {
+            unit = 1LL << 10;
+
+            end++;
+
+            break;
+        }
+
+        case 'm':
+        case 'M':
+        {
+            unit = 1LL << 20;
+
+            end++;
+
+            break;
+        }
+
+        case 'g':
+        case 'G':
+        {
+            unit = 1LL << 30;
+
+            end++;
+
+            break;
+        }
+    }
+
+    if ((end == str) || (*end != '\0') || errno || (amount < 0) || (amount > LLONG_MAX / unit))
+        return false;
+
+    *value = amount * unit;
+
+    return true;
+}
+
+/**
+ * @brief Esta función interpreta un conjunto de CPUs, como 'taskset'.
+ *
+ * @details Una máscara es un número hexadecimal (con o sin "0x") en el
+ *          que cada bit es una CPU, empezando por la CPU 0 en el bit
+ *          menos significativo. Una lista son CPUs y rangos separados
+ *          por comas, por ejemplo "0-3,8".
+ *
+ * @param str Conjunto a interpretar.
+ * @param list Si se trata de una lista en lugar de una máscara.
+ * @param set Donde se guarda el conjunto.
+ *
+ * @returns La cantidad de CPUs del conjunto, o 0 si no es válido.
+ */
+static int cpus_parse(char *str, bool list, cpu_set_t *set)
+{
+    CPU_ZERO(set);
+
+    if (!list)
+    {
+        if ((str[0] == '0') && ((str[1] == 'x') || (str[1] == 'X')))
+            str += 2;
+
+        int len = strlen(str);
+
+        for (int i = len - 1; i >= 0; i--)
+        {
+            char *digits = "0123456789abcdef0123456789ABCDEF";
+            char *digit = strchr(digits, str[i]);
+
+            if (!digit)
+                return 0;
+
+            for (int bit = 0; bit < 4; bit++)
+                if (((digit - digits) % 16) & (1 << bit))
+                {
+                    int cpu = ((len - 1 - i) * 4) + bit;
+
+                    if (cpu >= CPU_SETSIZE)
+                        return 0;
+
+                    CPU_SET(cpu, set);
+                }
+        }
+
+        return CPU_COUNT(set);
+    }
+
+    char *item = str;
+
+    while (true)
+    {
+        char *end;
+
+        long first = strtol(item, &end, 10);
+        long last = first;
+
+        if ((end == item) || (item[0] < '0') || (item[0] > '9'))
+            return 0;
+
+        if (*end == '-')
+        {
+            item = end + 1;
+
+            last = strtol(item, &end, 10);
+
+            if ((end == item) || (item[0] < '0') || (item[0] > '9'))
+                return 0;
+        }
+
+        if ((first > last) || (last >= CPU_SETSIZE))
+            return 0;
+
+        for (long cpu = first; cpu <= last; cpu++)
+            CPU_SET(cpu, set);
+
+        if (*end == '\0')
+            break;
+
+        if (*end != ',')
+            return 0;
+
+        item = end + 1;
+    }
+
+    return CPU_COUNT(set);
+}
+
+/**
+ * @brief Esta función interpreta los prefijos 'taskset', 'nice' y
+ *        'limit' de una línea.
+ *
+ * @details Se expanden sus variables y se validan antes de crear
+ *          cualquier proceso, de modo que un error no deja etapas
+ *          lanzadas. El ajuste de 'nice' se suma a la prioridad de la
+ *          shell, como en 'nice(1)'. Los límites se indican como
+ *          RECURSO=valor separados por comas, con los recursos mem
+ *          (memoria virtual, en bytes), cpu (segundos), nofile, nproc,
+ *          fsize, stack y core, y valores con los sufijos de
+ *          amount_parse o "unlimited"; se aplican como límite tanto
+ *          blando como duro, igual que 'ulimit'.
+ *
+ * @param pl Línea a ejecutar.
+ * @param setup Donde se guarda la configuración.
+ *
+ * @returns Si los prefijos son válidos. Si no, se informa el error.
+ */
+static bool setup_prepare(pipeline *pl, launch_setup *setup)
+{
+    static const struct
+    {
+        char *name;
+
+        int resource;
+    } resources[] = {
+        { "mem", RLIMIT_AS },
+        { "cpu", RLIMIT_CPU },
+        { "nofile", RLIMIT_NOFILE },
+        { "nproc", RLIMIT_NPROC },
+        { "fsize", RLIMIT_FSIZE },
+        { "stack", RLIMIT_STACK },
+        { "core", RLIMIT_CORE }
+    };
+
+    char msg[_STR_MAX_LEN_];
+
+    setup->spread = pl->spread;
+
+    if (pl->cpus)
+    {
+        char *cpus = strchr(pl->cpus, _VAR_MARK_) ? expand_word(&cmd_arena, pl->cpus) : pl->cpus;
+
+        if (!(setup->cpus_amount = cpus_parse(cpus, pl->cpus_list, &setup->cpus)))
+        {
+            snprintf(msg, sizeof(msg), "Invalid taskset CPU %s: %s", pl->cpus_list ? "list" : "mask", cpus);
+
+            show_err(msg, _NORM_ERR_);
+
+            return false;
+        }
+    }
+
+    if (pl->niceness)
+    {
+        char *niceness = strchr(pl->niceness, _VAR_MARK_) ? expand_word(&cmd_arena, pl->niceness) : pl->niceness;
+
+        char *end;
+
+        long adjustment = strtol(niceness, &end, 10);
+
+        if ((end == niceness) || (*end != '\0'))
+        {
+            snprintf(msg, sizeof(msg), "Invalid nice adjustment: %s", niceness);
+
+            show_err(msg, _NORM_ERR_);
+
+            return false;
+        }
+
+        // getpriority puede devolver -1 como prioridad válida
+        errno = 0;
+
+        long base = getpriority(PRIO_PROCESS, 0);
+
+        if (errno)
+            base = 0;
+
+        long niceness_value = base + adjustment;
+
+        setup->niceness = (niceness_value < -20) ? -20 : ((niceness_value > 19) ? 19 : (int)niceness_value);
+        setup->set_niceness = true;
+    }
+
+    if (!pl->limits)
+        return true;
+
+    char *limits = arena_strdup(&cmd_arena, strchr(pl->limits, _VAR_MARK_) ? expand_word(&cmd_arena, pl->limits) : pl->limits);
+
+    for (char *item = strtok(limits, ","); item; item = strtok(NULL, ","))
+    {
+        char *value = strchr(item, '=');
+
+        long long amount = 0;
+
+        int found = -1;
+
+        if (value)
+        {
+            *value++ = '\0';
+
+            for (int i = 0; i < (int)(sizeof(resources) / sizeof(resources[0])); i++)
+                if (strcmp(item, resources[i].name) == 0)
+                    found = i;
+        }
+
+        if ((found == -1) || (setup->limits_amount == _RLIMITS_MAX_) ||
+            ((strcmp(value, "unlimited") != 0) && !amount_parse(value, &amount)))
+        {
+            snprintf(msg, sizeof(msg), "Invalid resource limit: %s%s%s", item, value ? "=" : "", value ? value : "");
+
+            show_err(msg, _NORM_ERR_);
+
+            return false;
+        }
+
+        rlim_t limit = (strcmp(value, "unlimited") == 0) ? RLIM_INFINITY : (rlim_t)amount;
+
+        setup->resources[setup->limits_amount] = resources[found].resource;
+        setup->limits[setup->limits_amount].rlim_cur = limit;
+        setup->limits[setup->limits_amount].rlim_max = limit;
+        setup->limits_amount++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Esta función aplica al proceso actual la configuración de
+ *        los prefijos 'taskset', 'nice' y 'limit' de su línea.
+ *
+ * @details Se llama en el child process, después de aplicar sus
+ *          redirecciones (un límite de file descriptors podría
+ *          impedirlas) y antes de 'execv', por lo que el programa
+ *          arranca ya restringido y no hace falta otro proceso
+ *          intermedio.
+ *
+ * @param setup Configuración a aplicar.
+ *
+ * @returns Si se pudo aplicar toda la configuración. Si no, se
+ *          informa el error.
+ */
+static bool setup_apply(launch_setup *setup)
+{
+    char *err = NULL;
+
+    if (setup->cpus_amount && (sched_setaffinity(0, sizeof(cpu_set_t), &setup->cpus) == -1))
+        err = "Could not set CPU affinity";
+    else if (setup->set_niceness && (setpriority(PRIO_PROCESS, 0, setup->niceness) == -1))
+        err = "Could not set niceness";
+
+    for (int i = 0; (i < setup->limits_amount) && !err; i++)
+        if (setrlimit(setup->resources[i], &setup->limits[i]) == -1)
+            err = "Could not set resource limit";
+
+    if (!err)
+        return true;
+
+    char msg[_STR_MAX_LEN_];
+
+    snprintf(msg, sizeof(msg), "%s: %s", err, strerror(errno));
+
+    show_err(msg, _NORM_ERR_);
+
+    return false;
+}
+
+/**
+ * @brief Esta función obtiene la configuración de una etapa a partir
+ *        de la de su línea.
+ *
+ * @details Con 'taskset -s', la etapa i se fija a la i-ésima CPU del
+ *          conjunto (volviendo a empezar si hay más etapas que CPUs),
+ *          de modo que las etapas de un pipeline no compiten por la
+ *          misma CPU.
+ *
+ * @param setup Configuración de la línea, o NULL.
+ * @param index Posición de la etapa en la línea.
+ * @param stage_setup Donde se arma la configuración de la etapa, si
+ *                    hace falta.
+ *
+ * @returns La configuración de la etapa, o NULL si no tiene.
+ */
+static launch_setup *setup_stage(launch_setup *setup, int index, launch_setup *stage_setup)
+{
+    if (!setup || !setup->spread || !setup->cpus_amount)
+        return setup;
+
+    *stage_setup = *setup;
+
+    CPU_ZERO(&stage_setup->cpus);
+
+    for (int cpu = 0, seen = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &setup->cpus) && (seen++ == index % setup->cpus_amount))
+        {
+            CPU_SET(cpu, &stage_setup->cpus);
+
+            break;
+        }
+
+    stage_setup->cpus_amount = 1;
+
+    return stage_setup;
+}
+
+/**
+ * @brief Esta función crea un pipe para conectar dos etapas.
+ *
+ * @details Se crea con O_CLOEXEC, para que ningún programa herede
+ *          extremos de pipes que no le corresponden, y si se indica
+ *          una capacidad se la aplica con F_SETPIPE_SZ: con pipes
+ *          más grandes, las etapas que mueven bloques grandes se
+ *          bloquean (y cambian de contexto) menos veces. Si no se
+ *          puede aplicar (por ejemplo, al superar el límite de páginas
+ *          en pipes del usuario), el pipe conserva la capacidad por
+ *          defecto. La capacidad resultante se registra en sh_stats.
+ *
+ * @param fd Donde se guardan los extremos del pipe.
+ * @param size Capacidad a aplicar, o 0 para la del sistema.
+ */
+static void pipe_open(int fd[2], int size)
+{
+    if (pipe2(fd, O_CLOEXEC) == -1)
+        show_err("Failed to create pipe", _FATAL_ERR_);
+
+    int len = (size > 0) ? fcntl(fd[1], F_SETPIPE_SZ, size) : -1;
+
+    if ((size > 0) && (len == -1))
+        sh_stats.pipe_resize_errors++;
+
+    if (len == -1)
+        len = fcntl(fd[1], F_GETPIPE_SZ);
+
+    sh_stats.pipes++;
+    sh_stats.pipe_size = (len > 0) ? (uint64_t)len : 0;
+}
+
+/**
+ * @brief Esta función elige la etapa de un comando con pipes que se
+ *        ejecuta en el proceso de la shell, sin crear un proceso.
+ *
+ * @details Sólo puede ser la primera o la última etapa de un comando
+ *          en foreground y sin 'time', y debe ser un comando interno
+ *          que pueda ejecutarse en una copia de la shell. Se prefiere
+ *          la última, cuyo código de salida es el del comando. Se
+ *          excluye 'forall', que espera a sus propios procesos, y las
+ *          líneas con los prefijos 'taskset', 'nice' o 'limit'.
+ *
+ * @param pl Línea a ejecutar.
+ * @param stages Etapas preparadas de la línea.
+ *
+ * @returns El índice de la etapa, o -1 si ninguna puede ejecutarse así.
+ */
+static int inline_stage(pipeline *pl, stage *stages)
+{
+    int last = pl->cmds_amount - 1;
+
+    // La configuración de 'taskset', 'nice' y 'limit' no puede aplicarse a la shell
+    if (pl->bg || pl->timed || (last == 0) || pl->cpus || pl->niceness || pl->limits)
+        return -1;
+
+    int candidates[2] = { last, 0 };
+
+    for (int i = 0; i < 2; i++)
+    {
+        int id = stages[candidates[i]].builtin;
+
+        if (builtin_forkable(id) && (id != _BI_FORALL_))
+            return candidates[i];
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Esta función atiende la signal SIGTSTP mientras la shell
+ *        ejecuta una etapa de un comando con pipes.
+ *
+ * @details La shell no puede detenerse, por lo que el resto de las
+ *          etapas (que están en su mismo grupo de procesos) se
+ *          continúan. Así, la shell nunca queda bloqueada escribiendo
+ *          en un pipe cuyo lector se detuvo. Sólo se continúan los
+ *          procesos de este comando, y no otros trabajos detenidos
+ *          que compartan el grupo de procesos de la shell.
+ *
+ * @param sig Signal recibida.
+ */
+static void inline_sigtstp(int sig)
+{
+    (void)sig;
+
+    for (int i = 0; i < inline_pids_amount; i++)
+        kill(inline_pids[i], SIGCONT);
+}
+
+/**
+ * @brief Esta función ejecuta en el proceso de la shell la etapa de un
+ *        comando con pipes elegida por inline_stage, y luego espera al
+ *        resto de las etapas.
+ *
+ * @details El resto de las etapas ya fue lanzado y se registra como
+ *          trabajo antes de ejecutar el comando interno, para no
+ *          perder su estado si terminan mientras tanto. Los extremos
+ *          de pipe de la etapa se aplican como redirecciones previas
+ *          a las suyas, y se restauran al terminar. Mientras tanto se
+ *          ignora SIGPIPE, para que la shell no termine si el lector
+ *          termina antes (la salida restante se descarta), y se
+ *          habilita out_splice, ya que la salida no se modifica hasta
+ *          que la etapa termina.
+ *          Debe llamarse con SIGCHLD bloqueada, tal como run_job.
+ *
+ * @param pl Línea que originó el trabajo.
+ * @param st Etapa a ejecutar.
+ * @param in_fd Extremo de lectura del pipe de entrada, o -1.
+ * @param out_fd Extremo de escritura del pipe de salida, o -1.
+ * @param pids IDs de los procesos lanzados.
+ * @param pids_amount Cantidad de procesos.
+ */
+static void run_inline(pipeline *pl, stage *st, int in_fd, int out_fd, pid_t *pids, int pids_amount)
+{
+    int id = pids_amount ? job_add(pids, pids_amount, 0, pl->text, false) : 0;
+
+    int amount = 0;
+
+    redir *redirs = (redir *)arena_alloc(&cmd_arena, (st->redirs_amount + 2) * sizeof(redir));
+    int *saved = (int *)arena_alloc(&cmd_arena, (st->redirs_amount + 2) * sizeof(int));
+
+    if (in_fd != -1)
+        redirs[amount++] = (redir){ STDIN_FILENO, -1, in_fd, NULL };
+
+    if (out_fd != -1)
+        redirs[amount++] = (redir){ STDOUT_FILENO, -1, out_fd, NULL };
+
+    if (st->redirs_amount)
+        memcpy(redirs + amount, st->redirs, st->redirs_amount * sizeof(redir));
+
+    amount += st->redirs_amount;
+
+    struct sigaction ignore;
+    struct sigaction resume;
+    struct sigaction old_pipe;
+    struct sigaction old_tstp;
+
+    memset(&ignore, 0, sizeof(ignore));
+    memset(&resume, 0, sizeof(resume));
+
+    ignore.sa_handler = SIG_IGN;
+    resume.sa_handler = inline_sigtstp;
+    resume.sa_flags = SA_RESTART;
+
+    sigemptyset(&ignore.sa_mask);
+    sigemptyset(&resume.sa_mask);
+
+    inline_pids = pids;
+    inline_pids_amount = pids_amount;
+
+    sigaction(SIGPIPE, &ignore, &old_pipe);
+    sigaction(SIGTSTP, &resume, &old_tstp);
+
+    jobs_unblock();
+
+    int status = EXIT_FAILURE;
+
+    if (redirs_apply(redirs, amount, saved))
+    {
+        out_splice = true;
+
+        run_builtin(st);
+
+        out_flush();
+
+        out_splice = false;
+
+        status = last_status;
+
+        redirs_restore(redirs, amount, saved);
+    }
+
+    // Al cerrar los extremos, el resto de las etapas recibe EOF o SIGPIPE
+    if (in_fd != -1)
+        close(in_fd);
+
+    if (out_fd != -1)
+        close(out_fd);
+
+    jobs_block();
+
+    sigaction(SIGPIPE, &old_pipe, NULL);
+    sigaction(SIGTSTP, &old_tstp, NULL);
+
+    inline_pids_amount = 0;
+    inline_pids = NULL;
+
+    last_status = id ? job_wait(id, true, NULL) : EXIT_SUCCESS;
+
+    if (out_fd == -1)
+        last_status = status;
+}
+
+/**
+ * @brief Esta función espera a que termine uno de los comandos
+ *        lanzados por 'forall'.
+ *
+ * @param running Cantidad de comandos en ejecución.
+ * @param failed Cantidad de comandos que fallaron.
+ */
+static void forall_reap(int *running, int *failed)
+{
+    int code;
+
+    jobs_block();
+
+    if (jobs_wait_fg(&code) == -1)
+        *running = 0;
+    else
+    {
+        (*running)--;
+
+        if (code != EXIT_SUCCESS)
+            (*failed)++;
+    }
+
+    jobs_unblock();
+}
+
+/**
+ * @brief Esta función lanza uno de los comandos de 'forall',
+ *        esperando antes si ya se alcanzó el límite de comandos
+ *        en ejecución.
+ *
+ * @details Los comandos se lanzan directamente con launch_prog, sin
+ *          volver a analizar ni a buscar el programa, y se registran
+ *          en la tabla de trabajos para esperarlos en el orden en el
+ *          que terminan. Su stdin es /dev/null, para que no consuman
+ *          los elementos que lee 'forall'.
+ *
+ * @param path Path del programa.
+ * @param argv Argumentos del comando (terminados en NULL).
+ * @param max Máximo de comandos en ejecución.
+ * @param running Cantidad de comandos en ejecución.
+ * @param failed Cantidad de comandos que fallaron.
+ */
+static void forall_launch(char *path, char **argv, int max, int *running, int *failed)
+{
+    while (*running >= max)
+        forall_reap(running, failed);
+
+    jobs_block();
+
+    static redir dev_null = { STDIN_FILENO, O_RDONLY, -1, "/dev/null" };
+
+    pid_t pid = launch_prog(path, argv, -1, -1, &dev_null, 1, -1, NULL);
+
+    if (pid == -1)
+        (*failed)++;
+    else
+    {
+        job_add(&pid, 1, 0, argv[0], false);
+
+        (*running)++;
+    }
+
+    jobs_unblock();
+}
+
+/**
+ * @brief Esta función reemplaza cada '{}' de una palabra por un
+ *        elemento de 'forall'.
+ *
+ * @param a Arena de la que se reserva la palabra con los reemplazos.
+ * @param word Palabra de la plantilla.
+ * @param item Elemento a insertar.
+ * @param len Largo del elemento.
+ *
+ * @returns La palabra con los reemplazos, o la misma palabra si no
+ *          tiene nada para reemplazar.
+ */
+static char *forall_subst(arena *a, char *word, char *item, size_t len)
+{
+    size_t marks = 0;
+
+    for (char *c = strstr(word, "{}"); c; c = strstr(c + 2, "{}"))
+        marks++;
+
+    if (marks == 0)
+        return word;
+
+    char *result = (char *)arena_alloc(a, strlen(word) + (marks * len) + sizeof(NULL));
+    char *out = result;
+
+    for (char *c = word, *mark; ; c = mark + 2)
+    {
+        if (!(mark = strstr(c, "{}")))
+        {
+            strcpy(out, c);
+
+            break;
+        }
+
+        memcpy(out, c, mark - c);
+        out += mark - c;
+
+        memcpy(out, item, len);
+        out += len;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Esta función asigna un valor a una variable (NOMBRE=valor).
+ *
+ * @details El valor ya tiene sus variables expandidas. Si la variable
+ *          es de entorno se la modifica allí y, si no, se la guarda como
+ *          variable de la shell (ver var_set).
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_assign(char **args)
+{
+    char *eq = strchr(args[0], '=');
+
+    char *name = (char *)arena_alloc(&cmd_arena, (eq - args[0]) + sizeof(NULL));
+
+    memcpy(name, args[0], eq - args[0]);
+
+    name[eq - args[0]] = '\0';
+
+    var_set(name, eq + 1);
+}
+
+/**
+ * @brief Esta función cambia el directorio actual de trabajo.
+ *
+ * @details Se arma el nuevo directorio a partir del argumento recibido,
+ *          se utiliza la función 'chdir' para cambiar el directorio y
+ *          se modifican las variables de entorno $PWD y $OLDPWD con 'setenv'.
+ *          Por último, se actualiza el directorio guardado en el estado
+ *          de la shell, lo que marca al prompt para volver a armarse.
+ *
+ * @param args Argumentos del comando (el primero es el directorio).
+ */
+void cmd_cd(char **args)
+{
+    /*
+        Si el usuario no ingresó parámetros para 'cd', es un input
+        inválido. En ese caso, imprimimos un error y salimos.
+    */
+    char *aux = args[1];
+    char *new_dir;
+
+    if (aux == NULL)
+    {
+        show_err("Invalid cd command input", _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+
+        return;
+    }
+
+    if (strncmp(aux, "/", 1) == 0)
+    {
+        /*
+            Si el input comienza con el caracter '/' significa que queremos
+            movernos desde el sistema de archivos principal y para esto
+            utilizamos directamente este input como nuevo directorio.
+        */
+        new_dir = aux;
+    }
+    else if (strcmp(aux, "-") == 0)
+    {
+        /*
+            Si el input es '-' significa que el usuario quiere acceder a la carpeta
+            anterior, por lo que se hace cd con la variable de entorno $OLDPWD.
+            Se la copia porque 'setenv' la reemplaza antes de actualizar $PWD.
+        */
+        char *oldpwd = getenv("OLDPWD");
+
+        if (!oldpwd)
+        {
+            show_err("There is no value for OLDPWD environment variable yet", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+
+            return;
+        }
+
+        new_dir = arena_strdup(&cmd_arena, oldpwd);
+    }
+    else
+    {
+        /*
+            Si el input no es '-' y no contiene el caracter '/', significa que
+            queremos acceder a una carpeta dentro del directorio actual o queremos
+            ir a un directorio superior pasando por el directorio padre de la carpeta
+            en la que nos encontramos, por lo que concatenamos '/aux' al directorio
+            donde estamos (guardado en el estado de la shell).
+        */
+        new_dir = (char *)arena_alloc(&cmd_arena, strlen(shell_cwd) + strlen(aux) + sizeof(NULL) + sizeof(char)); // + 1 por "/"
+
+        strcpy(new_dir, shell_cwd);
+
+        // Si estamos en el sistema de archivos principal (/), no agregamos otro '/'
+        if (strcmp(shell_cwd, "/") != 0)
+            strcat(new_dir, "/");
+
+        strcat(new_dir, aux);
+    }
+
+    if (chdir(new_dir) != 0)
+    {
+        show_err(strerror(errno), _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+
+        return;
+    }
+
+    if (setenv("OLDPWD", getenv("PWD"), 1) == -1)
+        show_err("Could not modify OLDPWD environment variable", _FATAL_ERR_);
+
+    if (setenv("PWD", new_dir, 1) == -1)
+        show_err("Could not modify PWD environment variable", _FATAL_ERR_);
+
+    cwd_update();
+}
+
+/**
+ * @brief Esta función limpia la consola.
+ */
+void cmd_clr(void)
+{
+    out_write(_CLR_SCR_);
+}
+
+/**
+ * @brief Esta función muestra en pantalla los argumentos del
+ *        comando 'echo', o el contenido de su stdin si éste
+ *        fue redirigido a un archivo.
+ *
+ * @details Las variables de entorno ya fueron expandidas al preparar
+ *          el comando, por lo que los argumentos se muestran tal cual,
+ *          separados por un espacio (los extensos, con out_nsplice).
+ *          El contenido de stdin se copia con stream_fd, en bloques
+ *          grandes y sin pasar por la shell.
+ *
+ * @param args Argumentos del comando.
+ * @param from_stdin Si se debe mostrar el contenido de stdin.
+ */
+void cmd_echo(char **args, bool from_stdin)
+{
+    if (from_stdin)
+    {
+        out_flush();
+
+        // El archivo se copia dentro del kernel, sin importar su tamaño ni contenido
+        if (!stream_fd(STDIN_FILENO, STDOUT_FILENO))
+        {
+            // Si el lector del pipe terminó, no hay nada que informar
+            if (errno != EPIPE)
+                show_err(strerror(errno), _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+
+            return;
+        }
+
+        out_write("\n");
+
+        return;
+    }
+
+    for (int i = 1; args[i]; i++)
+    {
+        if (i > 1)
+            out_write(" ");
+
+        out_nsplice(args[i], strlen(args[i]));
+    }
+
+    out_write("\n");
+}
+
 /**
- * @brief Esta función cambia el directorio actual de trabajo.
+ * @brief Esta función ejecuta un comando por cada grupo de elementos
+ *        leídos de stdin o de un archivo, como 'xargs -P'.
  *
- * @details Se utiliza la función 'chdir' para cambiar el directorio y
- *          se modifican las variables de entorno $PWD y $OLDPWD con 'setenv'.
+ * @details Sintaxis: forall [-P N] [-n N] [-f ARCHIVO] COMANDO [ARGS...]
+ *          Cada línea no vacía de la entrada es un elemento. Si algún
+ *          argumento de la plantilla contiene '{}', se ejecuta un comando
+ *          por elemento, reemplazando allí cada '{}'. Si no, los elementos
+ *          se agregan al final de la plantilla en grupos tan grandes como
+ *          lo permita ARG_MAX (descontando el entorno y la plantilla), o
+ *          de hasta N elementos con '-n N'.
+ *          Se ejecutan hasta N comandos a la vez con '-P N' (por defecto,
+ *          tantos como procesadores). El programa se busca una única vez y
+ *          cada comando se lanza a medida que se completa su grupo, sin
+ *          esperar a que termine la entrada.
+ *          Si algún comando falla, se informa cuántos fallaron y el código
+ *          de salida es 123, como en 'xargs'. Lo mismo ocurre si algún
+ *          elemento no entra en ningún comando, que se informa aparte.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_forall(char **args)
+{
+    char *file = NULL;
+
+    long procs_max = sysconf(_SC_NPROCESSORS_ONLN);
+    long items_max = 0;
+
+    int i = 1;
+
+    if (procs_max < 1)
+        procs_max = 1;
+
+    while (args[i] && (args[i][0] == '-'))
+    {
+        if (strcmp(args[i], "--") == 0)
+        {
+            i++;
+
+            break;
+        }
+
+        if (!args[i + 1] || ((strcmp(args[i], "-P") != 0) && (strcmp(args[i], "-n") != 0) && (strcmp(args[i], "-f") != 0)))
+            break;
+
+        if (args[i][1] == 'f')
+            file = args[i + 1];
+        else
+        {
+            char *end;
+
+            long value = strtol(args[i + 1], &end, 10);
+
+            if ((*end != '\0') || (value < 1) || (value > INT_MAX))
+                break;
+
+            if (args[i][1] == 'P')
+                procs_max = value;
+            else
+                items_max = value;
+        }
+
+        i += 2;
+    }
+
+    if (!args[i] || (args[i][0] == '-'))
+    {
+        show_err("Invalid forall command input", _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+
+        return;
+    }
+
+    char **tmpl = &args[i];
+
+    int tmpl_argc = 0;
+
+    bool replace = false;
+
+    // Espacio disponible para los elementos, como lo calcula 'xargs'
+    long budget = sysconf(_SC_ARG_MAX) - 2048;
+
+    for (char **env = environ; *env; env++)
+        budget -= strlen(*env) + 1 + sizeof(char *);
+
+    for (; tmpl[tmpl_argc]; tmpl_argc++)
+    {
+        budget -= strlen(tmpl[tmpl_argc]) + 1 + sizeof(char *);
+
+        if (strstr(tmpl[tmpl_argc], "{}"))
+            replace = true;
+    }
+
+    char *path = strchr(tmpl[0], '/') ? tmpl[0] : hash_lookup(tmpl[0]);
+
+    if (!path || (budget <= 0))
+    {
+        show_err(path ? "Argument list too long" : "No such program found", _NORM_ERR_);
+
+        last_status = 127;
+
+        sh_stats.failed_execs++;
+
+        return;
+    }
+
+    int fd = file ? open(file, (O_RDONLY | O_CLOEXEC)) : STDIN_FILENO;
+
+    if (fd == -1)
+    {
+        show_err(strerror(errno), _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+
+        return;
+    }
+
+    /*
+        Argumentos del comando en armado: la plantilla y, a continuación,
+        los elementos del grupo, copiados en un buffer que no puede
+        superar ARG_MAX, por lo que se lo reserva una única vez.
+    */
+    size_t argv_cap = tmpl_argc + 1 + (replace ? 0 : 64);
+
+    char **argv = (char **)malloc(argv_cap * sizeof(char *));
+    char *items = replace ? NULL : (char *)malloc(budget);
+
+    if (!argv || (!replace && !items))
+        show_err("Could not allocate memory for forall arguments", _FATAL_ERR_);
+
+    memcpy(argv, tmpl, tmpl_argc * sizeof(char *));
+
+    int running = 0;
+    int failed = 0;
+    int launched = 0;
+    int skipped = 0; // Elementos que no entran en ningún comando
+    int batch = 0; // Elementos del grupo en armado
+
+    long used = 0; // Espacio ocupado por el grupo en armado
+
+    line_reader reader;
+
+    arena words = { NULL }; // Palabras con los reemplazos del comando en armado
+
+    size_t len;
+
+    char *item;
+
+    // Los comandos escriben directamente en stdout
+    out_flush();
+
+    reader_init(&reader, fd);
+
+    while ((item = reader_next(&reader, &len)) != NULL)
+    {
+        if (len == 0)
+            continue;
+
+        if (replace)
+        {
+            for (int k = 0; k < tmpl_argc; k++)
+                argv[k] = forall_subst(&words, tmpl[k], item, len);
+
+            argv[tmpl_argc] = NULL;
+
+            forall_launch(path, argv, (int)procs_max, &running, &failed);
+
+            launched++;
+
+            // Las palabras reemplazadas ya no hacen falta
+            arena_reset(&words);
+
+            continue;
+        }
+
+        long cost = len + 1 + sizeof(char *);
+
+        if (cost > budget)
+        {
+            show_err("Argument list too long", _NORM_ERR_);
+
+            skipped++;
+
+            continue;
+        }
+
+        if ((batch > 0) && ((used + cost > budget) || (items_max && (batch == items_max))))
+        {
+            argv[tmpl_argc + batch] = NULL;
+
+            forall_launch(path, argv, (int)procs_max, &running, &failed);
+
+            launched++;
+            batch = 0;
+            used = 0;
+        }
+
+        if ((size_t)(tmpl_argc + batch + 1) == argv_cap)
+        {
+            char **aux = (char **)realloc(argv, (argv_cap * 2) * sizeof(char *));
+
+            if (!aux)
+                show_err("Could not allocate memory for forall arguments", _FATAL_ERR_);
+
+            argv = aux;
+            argv_cap *= 2;
+        }
+
+        argv[tmpl_argc + batch] = memcpy(items + (used - (batch * sizeof(char *))), item, len + 1);
+
+        used += cost;
+        batch++;
+    }
+
+    if (batch > 0)
+    {
+        argv[tmpl_argc + batch] = NULL;
+
+        forall_launch(path, argv, (int)procs_max, &running, &failed);
+
+        launched++;
+    }
+
+    while (running > 0)
+        forall_reap(&running, &failed);
+
+    reader_free(&reader);
+    arena_free(&words);
+
+    free(argv);
+    free(items);
+
+    if (file)
+        close(fd);
+
+    if ((failed > 0) || (skipped > 0))
+    {
+        char msg[128];
+
+        if (skipped > 0)
+            snprintf(msg, sizeof(msg), "forall: %d of %d commands failed, %d items skipped", failed, launched, skipped);
+        else
+            snprintf(msg, sizeof(msg), "forall: %d of %d commands failed", failed, launched);
+
+        show_err(msg, _NORM_ERR_);
+
+        last_status = 123;
+    }
+}
+
+/**
+ * @brief Esta función administra la tabla de hashing de comandos.
+ *
+ * @details Sin argumentos, se muestra el contenido de la tabla.
+ *          Con 'hash -r' o 'rehash' se vacía la tabla, forzando a
+ *          que los programas se vuelvan a buscar en $PATH. Con
+ *          nombres de programas como argumentos, se los busca y se
+ *          los agrega a la tabla.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_hash(char **args)
+{
+    if ((strcmp(args[0], "rehash") == 0) || (args[1] && (strcmp(args[1], "-r") == 0)))
+    {
+        hash_reset();
+
+        return;
+    }
+
+    if (!args[1])
+    {
+        hash_show();
+
+        return;
+    }
+
+    for (int i = 1; args[i]; i++)
+        if (!hash_lookup(args[i]))
+        {
+            char err_msg[_STR_MAX_LEN_];
+
+            snprintf(err_msg, sizeof(err_msg), "hash: %s: not found", args[i]);
+
+            show_err(err_msg, _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+        }
+}
+
+/**
+ * @brief Esta función prepara un child process recién creado
+ *        para ejecutar un programa.
+ *
+ * @details Se restauran las señales que ignora la shell, se
+ *          desbloquea SIGCHLD, se ubica al proceso en el grupo
+ *          indicado y se configura que reciba la signal SIGTERM
+ *          cuando el parent process haya terminado.
+ *          Ante cualquier falla, el child process termina.
+ *
+ * @param parent_pid ID del proceso de la shell.
+ * @param pgid Grupo de procesos (0 para uno nuevo), o -1 para
+ *             quedarse en el de la shell.
+ */
+void child_setup(pid_t parent_pid, pid_t pgid)
+{
+    sigset_t mask;
+
+    sigemptyset(&mask);
+
+    if (signal(SIGINT, SIG_DFL) == SIG_ERR ||
+        signal(SIGTSTP, SIG_DFL) == SIG_ERR ||
+        signal(SIGQUIT, SIG_DFL) == SIG_ERR ||
+        signal(SIGTTOU, SIG_DFL) == SIG_ERR ||
+        sigprocmask(SIG_SETMASK, &mask, NULL) == -1)
+    {
+        show_err("Could not assign signal handlers to child process", _NORM_ERR_);
+
+        try_kill(getpid(), SIGTERM);
+    }
+
+    if ((pgid != -1) && (setpgid(0, pgid) == -1))
+    {
+        show_err("Could not set child process group", _NORM_ERR_);
+
+        try_kill(getpid(), SIGTERM);
+    }
+
+    /*
+        Testeamos en caso de que prctl falle o que el parent
+        process haya terminado justo antes de la llamada a prctl.
+    */
+    if ((prctl(PR_SET_PDEATHSIG, SIGTERM) == -1) || (getppid() != parent_pid))
+    {
+        show_err("Failure in prctl function", _NORM_ERR_);
+
+        try_kill(getpid(), SIGTERM);
+    }
+}
+
+/**
+ * @brief Esta función administra los trabajos de la shell.
+ *
+ * @details Comandos disponibles:
+ *          - jobs: muestra la tabla de trabajos.
+ *          - wait: espera a todos los trabajos en background.
+ *          - wait [pid|%n]: espera al trabajo indicado.
+ *          - wait -n: espera al próximo trabajo que termine.
+ *          - fg [pid|%n]: continúa el trabajo indicado (o el más
+ *            reciente) en foreground y lo espera.
+ *          - bg [pid|%n]: continúa en background el trabajo indicado
+ *            (o el más reciente).
+ *          El código de salida de los trabajos esperados se guarda
+ *          como último estado.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_jobs(char **args)
+{
+    char *cmd = args[0];
+    char *arg = args[1];
+
+    if (strcmp(cmd, "jobs") == 0)
+    {
+        jobs_show();
+
+        return;
+    }
+
+    // Los trabajos que se esperan o continúan pueden escribir en la misma salida
+    out_flush();
+
+    jobs_block();
+
+    if (strcmp(cmd, "wait") == 0)
+    {
+        if (!arg)
+        {
+            while (jobs_wait_any() != 127);
+
+            last_status = EXIT_SUCCESS;
+        }
+        else if (strcmp(arg, "-n") == 0)
+            last_status = jobs_wait_any();
+        else
+        {
+            job *j = job_find(arg);
+
+            if (!j)
+            {
+                show_err("wait: no such job", _NORM_ERR_);
+
+                last_status = 127;
+            }
+            else
+                last_status = job_wait(j->id, false, NULL);
+        }
+
+        jobs_unblock();
+
+        return;
+    }
+
+    job *j = job_find(arg);
+
+    if (!j)
+    {
+        show_err((strcmp(cmd, "fg") == 0) ? "fg: no such job" : "bg: no such job", _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+
+        jobs_unblock();
+
+        return;
+    }
+
+    char line[_STR_MAX_LEN_ + 16];
+
+    // Se continúa el grupo de procesos completo, o cada proceso si comparte el de la shell
+    if (j->pgid > 0)
+        kill(-j->pgid, SIGCONT);
+    else
+        for (int i = 0; i < j->procs_amount; i++)
+            if (!j->procs[i].done)
+                kill(j->procs[i].pid, SIGCONT);
+
+    /*
+        No esperamos a que SIGCHLD informe que los procesos continuaron:
+        si job_wait viera todavía el estado anterior, devolvería el
+        control enseguida creyendo que el trabajo sigue detenido.
+    */
+    for (int i = 0; i < j->procs_amount; i++)
+        j->procs[i].stopped = false;
+
+    j->state = _JOB_RUNNING_;
+
+    if (strcmp(cmd, "bg") == 0)
+    {
+        j->bg = true;
+
+        snprintf(line, sizeof(line), "[%d]  %s\n", j->id, j->cmd);
+
+        out_write(line);
+
+        last_status = EXIT_SUCCESS;
+
+        jobs_unblock();
+
+        return;
+    }
+
+    snprintf(line, sizeof(line), "%s\n", j->cmd);
+
+    out_write(line);
+    out_flush(); // Antes de que el trabajo vuelva a escribir en la terminal
+
+    /*
+        Si el trabajo tiene su propio grupo de procesos, le cedemos
+        la terminal mientras está en foreground y luego la recuperamos.
+    */
+    bool tty = (j->pgid > 0) && isatty(STDIN_FILENO);
+
+    if (tty)
+        tcsetpgrp(STDIN_FILENO, j->pgid);
+
+    j->bg = false;
+
+    last_status = job_wait(j->id, true, NULL);
+
+    if (tty)
+        tcsetpgrp(STDIN_FILENO, getpgrp());
+
+    jobs_unblock();
+}
+
+/**
+ * @brief Esta función muestra o modifica las opciones de la shell.
  *
- * @param dir Directorio al que se quiere cambiar.
+ * @details Sin argumentos, se muestran las opciones con sus valores.
+ *          Opciones disponibles:
+ *          - launcher fork|spawn: mecanismo con el que se lanzan los
+ *            programas externos (ver launch_prog).
+ *          - timeformat human|posix|json: formato del reporte de 'time'
+ *            (ver time_report).
+ *          - pipesize N|default: capacidad de los pipes que crea la
+ *            shell (ver pipe_size_parse).
+ *
+ * @param args Argumentos del comando.
  */
-void cmd_cd(char *dir)
+void cmd_set(char **args)
 {
-    if (chdir(dir) != 0)
+    static char *time_formats[] = { "human", "posix", "json" };
+
+    char *option = args[1];
+    char *value = option ? args[2] : NULL;
+
+    if (!option)
+    {
+        out_write((launch_mode == _LAUNCH_FORK_) ? "launcher fork\n" : "launcher spawn\n");
+        out_write("timeformat ");
+        out_write(time_formats[time_format]);
+        out_write("\n");
+
+        char buffer[64];
+
+        if (pipe_size)
+            snprintf(buffer, sizeof(buffer), "pipesize %d\n", pipe_size);
+        else
+            snprintf(buffer, sizeof(buffer), "pipesize default\n");
+
+        out_write(buffer);
+
+        return;
+    }
+
+    if ((strcmp(option, "pipesize") == 0) && value && !args[3])
+    {
+        int size = pipe_size_parse(value);
+
+        if (size != -1)
+        {
+            pipe_size = size;
+
+            return;
+        }
+    }
+
+    if ((strcmp(option, "timeformat") == 0) && value && !args[3])
+        for (int i = 0; i < (int)(sizeof(time_formats) / sizeof(time_formats[0])); i++)
+            if (strcmp(value, time_formats[i]) == 0)
+            {
+                time_format = i;
+
+                return;
+            }
+
+    if ((strcmp(option, "launcher") == 0) && value && !args[3])
     {
-        show_err(strerror(errno), _NORM_ERR_);
+        if (strcmp(value, "fork") == 0)
+        {
+            launch_mode = _LAUNCH_FORK_;
 
-        return;
+            return;
+        }
+
+        if (strcmp(value, "spawn") == 0)
+        {
+            launch_mode = _LAUNCH_SPAWN_;
+
+            return;
+        }
     }
 
-    if (setenv("OLDPWD", getenv("PWD"), 1) == -1)
-        show_err("Could not modify OLDPWD environment variable", _FATAL_ERR_);
+    show_err("Invalid set command input", _NORM_ERR_);
 
-    if (setenv("PWD", dir, 1) == -1)
-        show_err("Could not modify PWD environment variable", _FATAL_ERR_);
+    last_status = EXIT_FAILURE;
 }
 
 /**
- * @brief Esta función limpia la consola.
+ * @brief Esta función muestra o reinicia las estadísticas internas
+ *        de la shell.
+ *
+ * @details Sin argumentos, se muestran los contadores y las latencias
+ *          de cada fase en una tabla. Con '-j' (o '--json'), se los
+ *          muestra como un objeto JSON en una línea, y con '-r' (o
+ *          '--reset') se los reinicia.
+ *
+ * @param args Argumentos del comando.
  */
-void cmd_clr(void)
+void cmd_shstat(char **args)
 {
-    try_write(STDOUT_FILENO, _CLR_SCR_);
+    if (!args[1])
+        stats_show(false);
+    else if (!args[2] && ((strcmp(args[1], "-j") == 0) || (strcmp(args[1], "--json") == 0)))
+        stats_show(true);
+    else if (!args[2] && ((strcmp(args[1], "-r") == 0) || (strcmp(args[1], "--reset") == 0)))
+        stats_reset();
+    else
+    {
+        show_err("Invalid shstat command input", _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+    }
 }
 
 /**
- * @brief Esta función se encarga de crear un child process y
- *        asignarle la tarea de ejecutar un programa recibido
- *        como parámetro. Se aceptan comandos con pipes.
+ * @brief Esta función interpreta una capacidad de pipe.
+ *
+ * @details Se admite un número de bytes (ver amount_parse), o
+ *          "default" para la capacidad por defecto del sistema. Los
+ *          valores mayores al máximo que se puede pedir sin privilegios
+ *          (_PIPE_MAX_SIZE_PATH_) se limitan a ese máximo. El kernel
+ *          redondea la capacidad a una potencia de 2 de páginas al
+ *          aplicarla.
  *
- * @details Antes de llamar a esta función, debe llamarse a
- *          la función get_prog_data de la librería
- *          shell_utilities para poder setear el nombre,
- *          path y los argumentos del programa a ejecutar.
+ * @param str Capacidad a interpretar.
+ *
+ * @returns La capacidad en bytes, 0 para la del sistema, o -1 si
+ *          no es válida.
  */
-void cmd_exec(void)
+int pipe_size_parse(char *str)
 {
-    /*
-        File descriptors para pipes.
+    static long max_size = -1;
 
-        fd[0] > lectura
-        fd[1] > escritura
-    */
-    int fd[2];
+    if (strcmp(str, "default") == 0)
+        return 0;
 
-    /*
-        Si el comando contiene pipes, se arma de a uno por vez,
-        se recorta el string desde un caracter '|' hasta el
-        salto de línea y se ejecuta de manera recursiva cada
-        comando, creando tantos pipes como sea necesario.
-    */
-    if (pipe_flag)
-    {
-        if (pipe(fd) == -1)
-            show_err("Failed to create pipe", _FATAL_ERR_);
+    long long size;
 
-        strcpy(aux_input, input);
-        strtok(aux_input, "|");
+    if (!amount_parse(str, &size) || (size <= 0))
+        return -1;
 
-        pipe_cmd = strtrim(strtok(NULL, "\n"));
+    // El máximo se lee una única vez
+    if (max_size == -1)
+    {
+        FILE *file = fopen(_PIPE_MAX_SIZE_PATH_, "r");
+
+        if (!file || (fscanf(file, "%ld", &max_size) != 1))
+            max_size = 0;
 
-        strcpy(input, pipe_cmd);
+        if (file)
+            fclose(file);
     }
 
-    pid_t parent_pid = getpid();
-    pid_t child_pid = fork();
+    if ((max_size > 0) && (size > max_size))
+        size = max_size;
+
+    return (size > INT_MAX) ? -1 : (int)size;
+}
+
+/**
+ * @brief Esta función lanza un programa externo en un nuevo
+ *        proceso, con el mecanismo indicado en launch_mode.
+ *
+ * @details Con _LAUNCH_FORK_ se utiliza 'fork' y el child process
+ *          prepara sus señales, pipes y redirecciones antes de
+ *          llamar a 'execv'.
+ *          Con _LAUNCH_SPAWN_ se utiliza 'posix_spawn', que en glibc
+ *          crea el proceso con clone(CLONE_VM | CLONE_VFORK): no se
+ *          copian las tablas de páginas de la shell, por lo que el
+ *          costo de lanzar un programa no depende de la memoria que
+ *          ésta tenga reservada. Las señales, pipes y redirecciones
+ *          se aplican como atributos y file actions del spawn. En
+ *          este modo no se configura PR_SET_PDEATHSIG.
+ *          En ambos casos, los archivos de las redirecciones se abren
+ *          sólo en el nuevo proceso, y después de conectar los pipes,
+ *          por lo que las redirecciones tienen prioridad sobre ellos.
+ *          Si se indica una configuración (prefijos 'taskset', 'nice' y
+ *          'limit'), se utiliza siempre 'fork', ya que sólo el child
+ *          process puede aplicarla sobre sí mismo antes de 'execv'.
+ *          Si el programa no pudo lanzarse, last_status queda con el
+ *          código de salida correspondiente (127 si no existe, o 1 si
+ *          falló una redirección).
+ *
+ * @param path Path absoluto del programa.
+ * @param args Argumentos del programa (terminados en NULL).
+ * @param in_fd File descriptor a utilizar como stdin, o -1.
+ * @param out_fd File descriptor a utilizar como stdout, o -1.
+ * @param redirs Redirecciones a aplicar, en orden.
+ * @param redirs_amount Cantidad de redirecciones.
+ * @param pgid Grupo de procesos (0 para uno nuevo), o -1 para
+ *             quedarse en el de la shell.
+ * @param setup Configuración a aplicar antes de 'execv' (ver
+ *              setup_apply), o NULL.
+ *
+ * @returns El ID del proceso lanzado, o -1 si no se pudo lanzar.
+ */
+pid_t launch_prog(char *path, char **args, int in_fd, int out_fd, redir *redirs, int redirs_amount, pid_t pgid,
+                  launch_setup *setup)
+{
+    pid_t child_pid;
 
-    switch (child_pid)
+    // 'posix_spawn' no puede aplicar afinidad, prioridad ni límites en el nuevo proceso
+    if ((launch_mode == _LAUNCH_FORK_) || setup)
     {
-        // Rutina del parent process en caso de fallo en fork
-        case -1:
+        pid_t parent_pid = getpid();
+
+        child_pid = fork();
+
+        if (child_pid == -1)
             show_err("Fork failed", _FATAL_ERR_);
 
-        // Rutina del child process
-        case 0:
+        sh_stats.forks++;
+
+        if (child_pid == 0)
         {
-            if (signal(SIGINT, SIG_DFL) == SIG_ERR ||
-                signal(SIGTSTP, SIG_DFL) == SIG_ERR ||
-                signal(SIGQUIT, SIG_DFL) == SIG_ERR)
-            {
-                show_err("Could not assign signal handlers to child process", _NORM_ERR_);
+            child_setup(parent_pid, pgid);
 
+            if (((in_fd != -1) && (dup2(in_fd, STDIN_FILENO) == -1)) ||
+                ((out_fd != -1) && (dup2(out_fd, STDOUT_FILENO) == -1)))
                 try_kill(getpid(), SIGTERM);
-            }
+
+            if (!redirs_apply(redirs, redirs_amount, NULL) || (setup && !setup_apply(setup)))
+                exit(EXIT_FAILURE);
 
             /*
-                Configuramos que el child process reciba la signal
-                SIGTERM cuando el parent process haya terminado.
-                Testeamos en caso de que prctl falle o que el parent
-                process haya terminado justo antes de la llamada a prctl.
+                El path del programa ya fue resuelto por el parent process
+                (los programas estándar, mediante la tabla de hashing de
+                comandos), por lo que sólo hace falta un intento de 'execv'.
             */
-            if ((prctl(PR_SET_PDEATHSIG, SIGTERM) == -1) || (getppid() != parent_pid))
-            {
-                show_err("Failure in prctl function", _NORM_ERR_);
+            execv(path, args);
 
-                try_kill(getpid(), SIGTERM);
-            }
+            show_err("No such program found", _NORM_ERR_);
 
-            if (redirect_stdin_flag && !redirect_stdx(new_stdin_name, STDIN_FILENO))
-                try_kill(getpid(), SIGTERM);
+            try_kill(getpid(), SIGTERM);
+        }
 
-            /*
-                Si hay pipes, redirigimos el stdout al file descriptor
-                especificado como de escritura para este proceso.
-                Cerramos los extremos que no se utilicen para evitar
-                file descriptors duplicados o inutilizados.
-            */
-            if (pipe_flag)
-            {
-                dup2(fd[1], STDOUT_FILENO);
+        // También desde el parent process, para no depender del orden de ejecución
+        if (pgid != -1)
+            setpgid(child_pid, pgid ? pgid : child_pid);
 
-                close(fd[0]);
-                close(fd[1]);
-            }
+        return child_pid;
+    }
 
-            /*
-                Si el input fue detectado como un programa estándar, se lo
-                buscará en todas las direcciones de $PATH.
-                Ante la primera coincidencia con el programa, el proceso hijo
-                no retornará, entonces no se seguirá buscando y así nos garantizamos
-                que el programa se ejecutará sólo una vez y en la primera coincidencia.
-            */
-            if (prog_type == _STD_)
-            {
-                char *path = getenv("PATH");
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_t actions;
 
-                if (!path)
-                {
-                    show_err("Could not get PATH environment variable", _NORM_ERR_);
+    sigset_t sig_default;
+    sigset_t sig_mask;
 
-                    try_kill(getpid(), SIGTERM);
-                }
+    /*
+        Las señales que ignora la shell vuelven a su comportamiento por
+        defecto en el nuevo proceso, y éste no hereda señales bloqueadas.
+    */
+    sigemptyset(&sig_default);
+    sigaddset(&sig_default, SIGINT);
+    sigaddset(&sig_default, SIGTSTP);
+    sigaddset(&sig_default, SIGQUIT);
+    sigaddset(&sig_default, SIGTTOU);
 
-                char *aux_path = (char *)malloc(strlen(path) + sizeof(NULL));
+    sigemptyset(&sig_mask);
 
-                if (!aux_path)
-                {
-                    show_err("Could not allocate memory for PATH environment variable", _NORM_ERR_);
+    short flags = POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK;
 
-                    try_kill(getpid(), SIGTERM);
-                }
+    if (pgid != -1)
+        flags |= POSIX_SPAWN_SETPGROUP;
 
-                // Tomo el primer directorio en $PATH y le concateno el nombre del programa
-                strcpy(aux_path, path);
+    if ((posix_spawnattr_init(&attr) != 0) ||
+        (posix_spawnattr_setflags(&attr, flags) != 0) ||
+        (posix_spawnattr_setsigdefault(&attr, &sig_default) != 0) ||
+        (posix_spawnattr_setsigmask(&attr, &sig_mask) != 0) ||
+        ((pgid != -1) && (posix_spawnattr_setpgroup(&attr, pgid) != 0)) ||
+        (posix_spawn_file_actions_init(&actions) != 0))
+        show_err("Could not set up program launch attributes", _FATAL_ERR_);
 
-                char *next_dir = strtok(aux_path, ":");
+    if (((in_fd != -1) && (posix_spawn_file_actions_adddup2(&actions, in_fd, STDIN_FILENO) != 0)) ||
+        ((out_fd != -1) && (posix_spawn_file_actions_adddup2(&actions, out_fd, STDOUT_FILENO) != 0)))
+        show_err("Could not set up program launch file actions", _FATAL_ERR_);
 
-                // Búsqueda del programa en los directorios de $PATH
-                do
-                {
-                    strcpy(prog_path, next_dir);
+    for (int i = 0; i < redirs_amount; i++)
+    {
+        redir *r = &redirs[i];
 
-                    strcat(prog_path, "/");
-                    strcat(prog_path, prog_args[0]);
+        int err = r->file ? posix_spawn_file_actions_addopen(&actions, r->fd, r->file, r->flags, 0666)
+                          : posix_spawn_file_actions_adddup2(&actions, r->dup_fd, r->fd);
 
-                    execv(prog_path, prog_args);
-                } while ((next_dir = strtok(NULL, ":")) != NULL);
+        if (err != 0)
+            show_err("Could not set up program launch file actions", _FATAL_ERR_);
+    }
 
-                show_err("No such program found", _NORM_ERR_);
+    int err = posix_spawn(&child_pid, path, &actions, &attr, args, environ);
 
-                try_kill(getpid(), SIGTERM);
-            }
-            else if (execv(prog_path, prog_args) == -1)
-            {
-                show_err("No such program found", _NORM_ERR_);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
 
-                try_kill(getpid(), SIGTERM);
-            }
-        }
+    if (err != 0)
+    {
+        /*
+            Los errores de las file actions y de 'execve' se informan de
+            la misma manera, por lo que si el programa existe, el error
+            corresponde a alguna de las redirecciones.
+        */
+        bool redir_failed = (redirs_amount > 0) && (access(path, X_OK) == 0);
 
-        // Rutina del parent process en caso de fork exitoso
-        default:
+        if (redir_failed)
         {
-            if (!bg_flag)
-            {
-                if ((wait(NULL) == -1))
-                    show_err("Parent process failed waiting for child process", _FATAL_ERR_);
-
-                /*
-                    Si hay pipes, hacemos fork nuevamente creando un nuevo child process
-                    (en este punto podemos estar hablando de procesos hijos de padres
-                    anteriores que están creando procesos hijos para sí mismos).
-                */
-                if (pipe_flag)
-                {
-                    int new_child_pid = fork();
-
-                    switch (new_child_pid)
-                    {
-                        case -1:
-                            show_err("Pipe fork failed", _FATAL_ERR_);
-
-                        case 0:
-                        {
-                            /*
-                                Redirigimos el stdin de este proceso hijo al
-                                file descriptor especificado como de lectura
-                                y cerramos los demás file descriptors.
-                            */
-                            dup2(fd[0], STDIN_FILENO);
-
-                            close(fd[0]);
-                            close(fd[1]);
-
-                            /*
-                                En este punto ponemos la flag de pipes a 'false'
-                                y analizamos el string recortado entre un '|' y
-                                el salto de línea. Si hay más pipes, la flag se
-                                levantará de nuevo.
-                                Luego, con el string analizado, se ejecutará lo
-                                correspondiente, permitiendo recursividad.
-                                Al final la ejecución se termina este proceso.
-                            */
-                            pipe_flag = false;
-
-                            read_line(input);
-
-                            try_kill(getpid(), SIGTERM);
-                        }
-
-                        default:
-                        {
-                            /*
-                                El proceso padre (que aquí puede ser un proceso hijo)
-                                cierra los file descriptors que no utiliza.
-                                Si no hay procesos hijos que esperar, matamos este
-                                subproceso para finalizar su ejecución.
-                            */
-                            close(fd[0]);
-                            close(fd[1]);
-
-                            if ((wait(NULL) == -1))
-                                try_kill(getpid(), SIGTERM);
-
-                            break;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                // + 7 de "PID: []" y + 2 de "\n"
-                char *buffer = (char *)malloc(((sizeof(child_pid)) / (sizeof(int))) + sizeof(NULL) + (sizeof(char) * 9));
+            char msg[_STR_MAX_LEN_];
 
-                if (!buffer)
-                    show_err("Could not allocate memory for child process information message", _FATAL_ERR_);
+            snprintf(msg, sizeof(msg), "Could not apply redirections: %s", strerror(err));
 
-                sprintf(buffer, "PID: [%d]\n", child_pid);
+            show_err(msg, _NORM_ERR_);
+        }
+        else
+            show_err((err == ENOENT) ? "No such program found" : strerror(err), _NORM_ERR_);
 
-                try_write(STDOUT_FILENO, buffer);
-            }
+        last_status = redir_failed ? EXIT_FAILURE : 127;
 
-            return;
-        }
+        sh_stats.failed_execs++;
+
+        return -1;
     }
+
+    sh_stats.spawns++;
+
+    return child_pid;
 }
 
 /**
- * @brief Esta función muestra en pantalla el comentario o
- *        variable de entorno que acompaña al comando 'echo'.
+ * @brief Esta función registra en la tabla de trabajos los procesos
+ *        recién lanzados y, si corresponde, los espera.
  *
- * @details Se toma el input y se lo muestra como comentario o
- *          como variable de entorno en base al parámetro en_var.
+ * @details Debe llamarse con SIGCHLD bloqueada desde antes de lanzar
+ *          los procesos. Los trabajos en foreground se esperan hasta
+ *          que terminen o se detengan (por ejemplo, con SIGTSTP), en
+ *          cuyo caso quedan en la tabla para continuarlos con 'fg' o
+ *          'bg'. De los trabajos en background sólo se informa su
+ *          número y el ID de su último proceso.
  *
- * @param input String a mostrar.
- * @param is_env_var Si lo que se va a mostrar es una variable de entorno.
- *
- * @returns Si la impresión fue exitosa.
+ * @param pl Línea que originó el trabajo.
+ * @param pids IDs de los procesos lanzados.
+ * @param pids_amount Cantidad de procesos.
+ * @param pgid Grupo de procesos del trabajo, o 0.
+ * @param procs Donde se copian los procesos del trabajo en foreground
+ *              cuando termina, o NULL.
  */
-bool cmd_echo(char *input, bool is_env_var)
+void run_job(pipeline *pl, pid_t *pids, int pids_amount, pid_t pgid, proc *procs)
 {
-    if (is_env_var)
+    int id = job_add(pids, pids_amount, pgid, pl->text, pl->bg);
+
+    if (!pl->bg)
     {
-        char *env_var = getenv(input);
+        last_status = job_wait(id, true, procs);
 
-        if (!env_var)
-        {
-            show_err("Invalid environment variable - no match", _NORM_ERR_);
+        return;
+    }
 
-            return false;
-        }
+    char buffer[64];
 
-        try_write(STDOUT_FILENO, env_var);
-    }
-    else
-        try_write(STDOUT_FILENO, input);
+    snprintf(buffer, sizeof(buffer), "[%d] PID: [%d]\n", id, pids[pids_amount - 1]);
 
-    return true;
+    out_write(buffer);
+
+    last_status = EXIT_SUCCESS;
 }
 
 /**
- * @brief Esta función analiza una línea a ejecutar, recopilando información
- *        sobre las flags de comandos internos y el nombre, path y los
- *        argumentos de los programas externos a ejecutar. Luego, ejecuta
- *        lo correspondiente.
- *
- * @details Antes de ejecutar un programa, debe llamarse a esta función para
- *          setear sus datos correctamente.
+ * @brief Esta función ejecuta un comando, con o sin pipes,
+ *        lanzando todas sus etapas de manera concurrente.
  *
- * @param input String a analizar.
+ * @details Las etapas ya fueron preparadas por exec_line, de modo
+ *          que si algún programa no existe no se crea ningún proceso.
+ *          Se crean los child processes de izquierda a derecha,
+ *          conectando el stdout de cada etapa con el stdin de la
+ *          siguiente, y recién al final se espera a todos juntos.
+ *          Así, todas las etapas corren en paralelo y ninguna queda
+ *          bloqueada por llenar el buffer de su pipe.
+ *          Las redirecciones de cada etapa se aplican sólo en su
+ *          child process y tienen prioridad sobre los pipes.
+ *          Las etapas con comandos internos se ejecutan en una copia de
+ *          la shell, salvo la que elige inline_stage, que se ejecuta en
+ *          la propia shell una vez lanzado el resto (ver run_inline).
+ *          Los pipes se crean con la capacidad indicada con el prefijo
+ *          'pipesize' o, si no, con la de 'set pipesize' (pipe_size).
+ *          Los prefijos 'taskset', 'nice' y 'limit' se aplican en cada
+ *          child process antes de 'execv' (ver setup_stage).
+ *          Se guarda como último estado el de la última etapa.
+ *          Si la línea comienza con 'time' y se ejecuta en foreground,
+ *          al terminar se muestran los recursos que consumió cada etapa,
+ *          tal como los recolectó 'wait4' en el handler de SIGCHLD.
  *
- * @returns Si el usuario quiere terminar el programa.
+ * @param pl Línea a ejecutar.
+ * @param stages Etapas preparadas de la línea.
  */
-bool read_line(char *input)
+void cmd_exec(pipeline *pl, stage *stages)
 {
-    if ((set_flags(input) == -1) ||
-        (pipe_flag && (cd_flag || clr_flag || quit_flag)))
-        return false;
+    int stages_amount = pl->cmds_amount;
+    int size = pipe_size;
 
-    if (quit_flag && !(cd_flag || clr_flag || echo_flag || redirect_stdin_flag || redirect_stdout_flag))
-        return true;
-    else if (cd_flag && !(quit_flag || clr_flag || echo_flag || redirect_stdin_flag || redirect_stdout_flag))
+    // La capacidad indicada con 'pipesize' reemplaza a la de la shell
+    if (pl->pipe_size)
     {
-        /*
-            Si nos queremos mover de directorio, hacemos strtok al input
-            con " \t" y "\n" para obtener el directorio al que queremos ir.
-            Si obtenemos NULL, significa que el usuario no ingresó parámetros
-            para 'cd' y eso es un input inválido. En ese caso, imprimimos un
-            error y salimos.
-        */
-        strtok(input, " \t");
+        char *word = strchr(pl->pipe_size, _VAR_MARK_) ? expand_word(&cmd_arena, pl->pipe_size) : pl->pipe_size;
+
+        if ((size = pipe_size_parse(word)) == -1)
+        {
+            show_err("Invalid pipe size", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+
+            return;
+        }
+    }
 
-        char *aux = strtok(NULL, " \t\n");
-        char *new_dir;
+    launch_setup *setup = NULL;
+    launch_setup stage_setup;
+
+    if (pl->cpus || pl->niceness || pl->limits)
+    {
+        setup = (launch_setup *)arena_calloc(&cmd_arena, 1, sizeof(launch_setup));
 
-        if (aux == NULL)
+        if (!setup_prepare(pl, setup))
         {
-            show_err("Invalid cd command input", _NORM_ERR_);
+            last_status = EXIT_FAILURE;
 
-            return false;
+            return;
         }
+    }
+
+    pid_t *pids = (pid_t *)arena_alloc(&cmd_arena, stages_amount * sizeof(pid_t));
+
+    pid_t parent_pid = getpid();
+    pid_t pgid = pl->bg ? 0 : -1; // Los trabajos en background tienen su propio grupo
+
+    int prev_read = -1;
+    int launched = 0;
+    int failed_status = 0;
+
+    bool last_failed = false;
+    bool timed = pl->timed && !pl->bg;
+
+    // Etapa correspondiente a cada proceso lanzado, para el reporte de 'time'
+    int *launched_stage = timed ? (int *)arena_alloc(&cmd_arena, stages_amount * sizeof(int)) : NULL;
+
+    struct timespec start;
+
+    // Etapa que se ejecuta en la shell, y sus extremos de pipe
+    int inline_idx = inline_stage(pl, stages);
+    int inline_in = -1;
+    int inline_out = -1;
+
+    // Los child processes no deben heredar salida pendiente de la shell
+    out_flush();
 
-        if (strncmp(aux, "/", 1) == 0)
+    if (timed)
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+    jobs_block();
+
+    for (int i = 0; i < stages_amount; i++)
+    {
+        stage *st = &stages[i];
+
+        /*
+            File descriptors para el pipe de salida de esta etapa.
+
+            fd[0] > lectura
+            fd[1] > escritura
+        */
+        int fd[2] = { -1, -1 };
+
+        if (i < stages_amount - 1)
+            pipe_open(fd, size);
+
+        // Se ejecuta al final, una vez lanzado el resto (ver run_inline)
+        if (i == inline_idx)
         {
-            /*
-                Si el input comienza con el caracter '/' significa que queremos
-                movernos desde el sistema de archivos principal y para esto
-                reemplazamos la variable new_dir con el valor de este input.
-            */
-            new_dir = (char *)malloc(strlen(aux) + sizeof(NULL));
+            inline_in = prev_read;
+            inline_out = fd[1];
 
-            if (!new_dir)
-                show_err("Could not allocate memory for new path in cd command", _FATAL_ERR_);
+            prev_read = fd[0];
 
-            strcpy(new_dir, aux);
+            continue;
         }
-        else if (strcmp(aux, "-") == 0)
+
+        uint64_t launch_start = stat_now();
+
+        launch_setup *st_setup = setup_stage(setup, i, &stage_setup);
+
+        if (st->path)
+            pids[launched] = launch_prog(st->path, st->args, prev_read, fd[1], st->redirs, st->redirs_amount, pgid, st_setup);
+        else
         {
-            /*
-                Si el input es '-' significa que el usuario quiere acceder a la carpeta
-                anterior, por lo que se hace cd con la variable de entorno $OLDPWD.
-            */
-            char *oldpwd = getenv("OLDPWD");
+            // Etapa con un comando interno: se ejecuta en una copia de la shell
+            pids[launched] = fork();
+
+            if (pids[launched] == -1)
+                show_err("Pipe fork failed", _FATAL_ERR_);
 
-            if (!oldpwd)
+            sh_stats.forks++;
+
+            if (pids[launched] == 0)
             {
-                show_err("There is no value for OLDPWD environment variable yet", _NORM_ERR_);
+                child_setup(parent_pid, pgid);
 
-                return false;
-            }
+                if (((prev_read != -1) && (dup2(prev_read, STDIN_FILENO) == -1)) ||
+                    ((fd[1] != -1) && (dup2(fd[1], STDOUT_FILENO) == -1)))
+                    try_kill(getpid(), SIGTERM);
 
-            new_dir = (char *)malloc(strlen(oldpwd) + sizeof(NULL));
+                if (!redirs_apply(st->redirs, st->redirs_amount, NULL) || (st_setup && !setup_apply(st_setup)))
+                    exit(EXIT_FAILURE);
 
-            if (!new_dir)
-                show_err("Could not allocate memory for new path in cd command", _FATAL_ERR_);
+                // No hay exec, cerramos los extremos a mano
+                close(prev_read);
+                close(fd[0]);
+                close(fd[1]);
+                close(inline_in);
+                close(inline_out);
 
-            strcpy(new_dir, oldpwd);
-        }
-        else
-        {
-            /*
-                Si el input no es '-' y no contiene el caracter '/', significa que
-                queremos acceder a una carpeta dentro del directorio actual o queremos
-                ir a un directorio superior pasando por el directorio padre de la carpeta
-                en la que nos encontramos, por lo que concatenamos '/aux' al directorio
-                donde estamos (obtenido mediante $PWD).
-                Primero chequeamos si estamos en el sistema de archivos principal (/) para no
-                concatenar otro caracter '/' y terminar con un directorio erróneo con '//'.
-            */
-            new_dir = (char *)malloc(strlen(getcwd(NULL, 0)) + strlen(aux) + sizeof(NULL) + (sizeof(char) * 2)); // + 2 por "/"
+                run_builtin(st);
 
-            if (!new_dir)
-                show_err("Could not allocate memory for new path in cd command", _FATAL_ERR_);
+                out_flush();
 
-            strcpy(new_dir, getcwd(NULL, 0));
+                exit(last_status);
+            }
 
-            strcat(new_dir, "/");
-            strcat(new_dir, aux);
+            if (pgid != -1)
+                setpgid(pids[launched], pgid ? pgid : pids[launched]);
         }
 
-        cmd_cd(new_dir);
-    }
-    else if (clr_flag && !(quit_flag || cd_flag || echo_flag || redirect_stdin_flag || redirect_stdout_flag))
-        cmd_clr();
-    else if (echo_flag && !(quit_flag || clr_flag || cd_flag))
-    {
-        if (redirect_stdout_flag)
+        stat_phase(_PH_LAUNCH_, launch_start);
+
+        // Si la etapa no pudo lanzarse, el error ya fue informado
+        if (pids[launched] != -1)
         {
-            if (!redirect_stdx(new_stdout_name, STDOUT_FILENO))
-            {
-                redirect_stdout_flag = false;
+            if (pgid == 0)
+                pgid = pids[launched];
 
-                return false;
-            }
+            if (timed)
+                launched_stage[launched] = i;
 
-            chop_to_char(input, ">");
+            launched++;
+        }
+        else if (i == stages_amount - 1)
+        {
+            last_failed = true;
+            failed_status = last_status;
         }
 
         /*
-            El input del usuario se divide en substrings.
-            Si algún substring contiene el símbolo '$' indicando que
-            se trata de una variable de entorno, se setea la flag
-            env_var para utilizar en cmd_echo.
-            Al finalizar, si hubo redirección de algún stream, se
-            restaura(n) a su estado inicial.
+            El parent process cierra los extremos que ya fueron
+            heredados y conserva sólo el de lectura de este pipe
+            para conectarlo con la siguiente etapa.
         */
-        char *token;
+        if (prev_read != -1)
+            close(prev_read);
+
+        if (fd[1] != -1)
+            close(fd[1]);
+
+        prev_read = fd[0];
+    }
 
-        if (!redirect_stdin_flag)
+    proc *procs = (timed && launched) ? (proc *)arena_calloc(&cmd_arena, launched, sizeof(proc)) : NULL;
+
+    if (inline_idx != -1)
+        run_inline(pl, &stages[inline_idx], inline_in, inline_out, pids, launched);
+    else if (launched > 0)
+        run_job(pl, pids, launched, pl->bg ? pgid : 0, procs);
+
+    // Si la última etapa no pudo lanzarse, se conserva el código de salida de la falla
+    if (last_failed)
+        last_status = failed_status;
+
+    jobs_unblock();
+
+    // Si el trabajo se detuvo, no hay nada que reportar todavía
+    if (procs && procs[0].done)
+    {
+        stage_time *times = (stage_time *)arena_alloc(&cmd_arena, launched * sizeof(stage_time));
+
+        double real = 0;
+
+        for (int i = 0; i < launched; i++)
         {
-            bool echo_err = false;
-            bool space = false;
+            times[i].name = stages[launched_stage[i]].args[0];
+            times[i].pid = procs[i].pid;
+            times[i].status = proc_code(&procs[i]);
+            times[i].real = ts_diff(&start, &procs[i].end);
+            times[i].usage = procs[i].usage;
+
+            if (times[i].real > real)
+                real = times[i].real;
+        }
 
-            strtok(input, " ");
+        time_report(pl->text, times, launched, real);
+    }
+}
 
-            while ((token = strtok(NULL, " \t")) != NULL)
-            {
-                if (space)
-                    try_write(STDOUT_FILENO, " ");
+/**
+ * @brief Esta función ejecuta una línea ya analizada por parse_line.
+ *
+ * @details Primero se preparan todas las etapas. Un comando interno
+ *          solo se ejecuta en el proceso de la shell, aplicando y luego
+ *          restaurando sus redirecciones. En un comando con pipes, en
+ *          background o con los prefijos 'taskset', 'nice' o 'limit'
+ *          sólo se admiten los comandos internos que no modifican el
+ *          estado de la shell (ver builtin_forkable), y el resto de los
+ *          casos se ejecutan con cmd_exec.
+ *
+ * @param pl Línea a ejecutar.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+bool exec_line(pipeline *pl)
+{
+    if (pl->cmds_amount == 0)
+        return false;
 
-                bool env_var = false;
+    stage *stages = (stage *)arena_calloc(&cmd_arena, pl->cmds_amount, sizeof(stage));
 
-                char *aux_token = strstr(token, "$");
+    bool ok = true;
+    bool quit = false;
 
-                // Chequeamos si el usuario sólo quiere imprimir el símbolo '$'
-                if (aux_token && *(aux_token + 1) != '\0')
-                {
-                    memmove(&token[0], &token[1], strlen(token));
+    uint64_t start = stat_now();
 
-                    env_var = true;
-                }
+    for (int i = 0; (i < pl->cmds_amount) && ok; i++)
+        ok = stage_prepare(&pl->cmds[i], &stages[i]);
 
-                if (!stremp(token) && !cmd_echo(token, env_var))
-                    echo_err = true;
+    stat_phase(_PH_PREPARE_, start);
 
-                if (!space)
-                    space = true;
-            }
+    for (int i = 0; (i < pl->cmds_amount) && ok && (pl->cmds_amount > 1); i++)
+        if ((stages[i].builtin != _BI_NONE_) && !builtin_forkable(stages[i].builtin))
+        {
+            show_err("Invalid commands combination", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
 
-            if (!echo_err)
-                try_write(STDOUT_FILENO, "\n");
+            ok = false;
         }
+
+    bool limited = pl->cpus || pl->niceness || pl->limits;
+    bool forked_builtin = (pl->bg || limited) && builtin_forkable(stages[0].builtin);
+
+    if (ok && (stages[0].builtin != _BI_NONE_) && (pl->cmds_amount == 1) && !forked_builtin)
+    {
+        stage *st = &stages[0];
+
+        if (pl->bg)
+        {
+            show_err("Invalid background execution command", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+        }
+        else if (limited)
+        {
+            show_err("Invalid taskset, nice or limit prefix for this command", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+        }
+        else if (st->builtin == _BI_QUIT_)
+            quit = true;
         else
         {
-            if (!redirect_stdx(new_stdin_name, STDIN_FILENO))
+            int *saved = st->redirs_amount ? (int *)arena_alloc(&cmd_arena, st->redirs_amount * sizeof(int)) : NULL;
+
+            if (!timed_redirect(st, saved))
+                last_status = EXIT_FAILURE;
+            else
             {
-                redirect_stdin_flag = false;
+                if (pl->timed)
+                    run_timed_builtin(pl, st);
+                else
+                    run_builtin(st);
 
-                return false;
+                // 'exec' sin programa deja sus redirecciones aplicadas a la shell
+                if ((st->builtin == _BI_EXEC_) && !st->args[1])
+                {
+                    for (int i = 0; i < st->redirs_amount; i++)
+                        if (saved[i] != -1)
+                            close(saved[i]);
+                }
+                else if (st->redirs_amount)
+                    redirs_restore(st->redirs, st->redirs_amount, saved);
             }
+        }
+    }
+    else if (ok)
+        cmd_exec(pl, stages);
 
-            size_t len = 0;
+    return quit;
+}
 
-            char *line = NULL;
+/**
+ * @brief Esta función ejecuta una línea ya analizada y libera la
+ *        memoria que se usó para analizarla y ejecutarla.
+ *
+ * @details Todo lo que se reserva para analizar y ejecutar la línea
+ *          sale de cmd_arena, que se reinicia al terminar. Así, la
+ *          memoria de la shell no crece con cada línea y se libera
+ *          en O(1), sin recorrer el árbol sintáctico.
+ *          Se mide el tiempo total de la línea sin contar la espera de
+ *          los procesos (ver stats_show).
+ *
+ * @param pl Línea analizada, reservada de cmd_arena.
+ * @param start Instante en el que se comenzó a analizar la línea.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+bool run_line(pipeline *pl, uint64_t start)
+{
+    sh_stats.commands++;
+    sh_stats.line_wait_ns = 0;
 
-            // Imprimimos línea por línea todo el archivo
-            while (getline(&line, &len, stdin) != -1)
-                try_write(STDOUT_FILENO, line);
+    bool quit = exec_line(pl);
 
-            try_write(STDOUT_FILENO, "\n");
+    arena_reset(&cmd_arena);
 
-            free(line); // Ver `man getline`
+    // La espera de los procesos no es tiempo agregado por la shell
+    stat_phase(_PH_OVERHEAD_, start + sh_stats.line_wait_ns);
 
-            /*
-                Si no le hacemos rewind al nuevo stdin, dos echoes consecutivos
-                al mismo archivo no funcionarán: el segundo echo quedará en el EOF
-                y no imprimirá nada.
-            */
-            rewind(stdin);
+    return quit;
+}
 
-            restore_stdx(STDIN_FILENO);
-        }
-    }
-    else if (!(quit_flag || cd_flag || clr_flag || echo_flag))
-    {
-        if (redirect_stdout_flag && !redirect_stdx(new_stdout_name, STDOUT_FILENO))
-            return false;
+/**
+ * @brief Esta función analiza una línea a ejecutar y, si no tiene
+ *        errores de sintaxis, la ejecuta (ver run_line).
+ *
+ * @param input String a analizar.
+ *
+ * @returns Si el usuario quiere terminar el programa.
+ */
+bool read_line(char *input)
+{
+    char *err;
 
-        get_prog_data(input);
+    uint64_t start = stat_now();
 
-        cmd_exec();
-    }
-    else
-        show_err("Invalid commands combination", _NORM_ERR_);
+    pipeline *pl = parse_line(&cmd_arena, input, &err);
+
+    stat_phase(_PH_PARSE_, start);
+
+    if (pl)
+        return run_line(pl, start);
+
+    show_err(err, _NORM_ERR_);
 
-    if (redirect_stdout_flag)
-        restore_stdx(STDOUT_FILENO);
+    sh_stats.parse_errors++;
+
+    last_status = 2; // Error de sintaxis, como en sh
+
+    arena_reset(&cmd_arena);
+
+    stat_phase(_PH_OVERHEAD_, start);
 
     return false;
-}
\ No newline at end of file
+}
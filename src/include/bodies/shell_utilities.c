@@ -10,39 +10,69 @@
 #include "../headers/shell_utilities.h"
 
 /**
- * @brief Esta función devuelve el prompt a mostrar por consola en formato
+ * @brief Esta función actualiza el directorio actual de trabajo
+ *        guardado en el estado de la shell.
+ *
+ * @details Sólo debe llamarse al iniciar la shell y cuando 'cd'
+ *          cambia de directorio, ya que ningún otro comando puede
+ *          modificar el directorio de la shell. Así, armar el prompt
+ *          no requiere ninguna llamada a 'getcwd'.
+ */
+void cwd_update(void)
+{
+    char *cwd = getcwd(NULL, 0);
+
+    if (!cwd)
+        show_err("Could not get the current working directory", _FATAL_ERR_);
+
+    free(shell_cwd);
+
+    shell_cwd = cwd;
+    prompt_stale = true;
+}
+
+/**
+ * @brief Esta función arma el prompt a mostrar por consola en formato
  *        "<user_name>\@<group_name>:<CWD>$".
  *
+ * @details El prompt se guarda ya armado en la variable prompt (con su
+ *          largo en prompt_len) y sólo se lo vuelve a armar si cambió
+ *          el usuario, el nombre de grupo o el directorio actual. En
+ *          el resto de los casos, esta función no hace nada.
+ *
  * @param user_name Nombre de usuario.
  * @param group_name Nombre de grupo (hostname).
- * @param prompt Prompt a modificar.
  */
-void mk_prompt(char *user_name, char *group_name, char **prompt)
+void mk_prompt(char *user_name, char *group_name)
 {
-    char *aux_prompt = (char *)realloc(*prompt, (malloc_usable_size(*prompt) + strlen(getcwd(NULL, 0)) + sizeof(NULL)));
+    static char *last_user = NULL;
+    static char *last_group = NULL;
 
-    if (!aux_prompt)
-    {
-        free(*prompt);
+    if (prompt && !prompt_stale && (strcmp(user_name, last_user) == 0) && (strcmp(group_name, last_group) == 0))
+        return;
 
-        show_err("Could not get enough memory for prompt reallocation", _FATAL_ERR_);
-    }
+    free(prompt);
+    free(last_user);
+    free(last_group);
+
+    size_t len = strlen(user_name) + strlen(group_name) + strlen(shell_cwd) +
+                 (strlen(_FG_COLOR_YELLOW_) * 3) + (strlen(_FG_COLOR_GREEN_) * 2) +
+                 strlen(_FG_COLOR_BLUE_) + strlen(_FORMAT_RESET_ALL_) + (sizeof(char) * 4); // + 4 por "@", ":" y "$ "
 
-    *prompt = aux_prompt;
-
-    strcpy(*prompt, _FG_COLOR_GREEN_);
-    strcat(*prompt, chop_to_char(user_name, "\n"));
-    strcat(*prompt, _FG_COLOR_YELLOW_);
-    strcat(*prompt, "@");
-    strcat(*prompt, _FG_COLOR_GREEN_);
-    strcat(*prompt, chop_to_char(group_name, "\n"));
-    strcat(*prompt, _FG_COLOR_YELLOW_);
-    strcat(*prompt, ":");
-    strcat(*prompt, _FG_COLOR_BLUE_);
-    strcat(*prompt, chop_to_char(getcwd(NULL, 0), "\n"));
-    strcat(*prompt, _FG_COLOR_YELLOW_);
-    strcat(*prompt, "$ ");
-    strcat(*prompt, _FORMAT_RESET_ALL_);
+    prompt = (char *)malloc(len + sizeof(NULL));
+    last_user = strdup(user_name);
+    last_group = strdup(group_name);
+
+    if (!prompt || !last_user || !last_group)
+        show_err("Could not allocate memory for prompt", _FATAL_ERR_);
+
+    prompt_len = snprintf(prompt, len + sizeof(NULL), "%s%s%s@%s%s%s:%s%s%s$ %s",
+                          _FG_COLOR_GREEN_, user_name, _FG_COLOR_YELLOW_,
+                          _FG_COLOR_GREEN_, group_name, _FG_COLOR_YELLOW_,
+                          _FG_COLOR_BLUE_, shell_cwd, _FG_COLOR_YELLOW_,
+                          _FORMAT_RESET_ALL_);
+
+    prompt_stale = false;
 }
 
 /**
@@ -116,10 +146,10 @@ void show_help(int h_type)
     
     if (h_type == _HELP_)
     {
-        // + 3187 por el largo del mensaje
-        char *h_general = malloc((strlen(_FORMAT_BOLD_) * 28) + (strlen(_FORMAT_RESET_ALL_) * 29) +
-                                 (strlen(_FG_COLOR_WHITE_) * 32) + (strlen(_BG_COLOR_LGRAY_) * 2) +
-                                 sizeof(NULL) + (sizeof(char) * 3187));
+        // + 3785 por el largo del mensaje
+        char *h_general = malloc((strlen(_FORMAT_BOLD_) * 31) + (strlen(_FORMAT_RESET_ALL_) * 32) +
+                                 (strlen(_FG_COLOR_WHITE_) * 35) + (strlen(_BG_COLOR_LGRAY_) * 2) +
+                                 sizeof(NULL) + (sizeof(char) * 3785));
 
         if (!h_general)
             show_err("Could not allocate memory for message", _FATAL_ERR_);
@@ -220,7 +250,19 @@ void show_help(int h_type)
         strcat(h_general, "bfs/");
         strcat(h_general, _FORMAT_RESET_ALL_);
         strcat(h_general, _FG_COLOR_WHITE_);
-        strcat(h_general, " folder created automatically by the makefile.\n\n");
+        strcat(h_general, " folder created automatically by the makefile.\n");
+        strcat(h_general, "By default, batchfiles run as fast as possible, without prompt, echo or pauses.\nTo show each line with the prompt and pause before executing it, add the option ");
+        strcat(h_general, _FORMAT_BOLD_);
+        strcat(h_general, "-t");
+        strcat(h_general, _FORMAT_RESET_ALL_);
+        strcat(h_general, _FG_COLOR_WHITE_);
+        strcat(h_general, " (or\n");
+        strcat(h_general, _FORMAT_BOLD_);
+        strcat(h_general, "--trace");
+        strcat(h_general, _FORMAT_RESET_ALL_);
+        strcat(h_general, _FG_COLOR_WHITE_);
+        strcat(h_general, ") before the batchfile name.\n");
+        strcat(h_general, "A batchfile name containing '/' is taken as the path to a script in any location.\nCommands can also be given with -c \"commands\" or read from stdin when it is not a\nterminal. These modes never show banners or prompts, and the shell exits with the\nstatus of the last command.\n\n");
         strcat(h_general, _FORMAT_BOLD_);
         strcat(h_general, "//////////////////////////////////////////////////////////////////////////////////////\n\n");
         strcat(h_general, "BACKGROUND EXECUTION\n\n");
@@ -240,29 +282,35 @@ void show_help(int h_type)
         strcat(h_general, "I/O REDIRECTION\n\n");
         strcat(h_general, _FORMAT_RESET_ALL_);
         strcat(h_general, _FG_COLOR_WHITE_);
-        strcat(h_general, "The user can redirect the input and/or output stream(s).\n");
-        strcat(h_general, "For both cases, the new stream file must be placed in their corresponding folder.\n");
-        strcat(h_general, "New stdin streams will be searched only in ");
+        strcat(h_general, "The user can redirect the input, output and error streams of each command to any file,\n");
+        strcat(h_general, "given by its absolute path or relative to the current directory.\n");
+        strcat(h_general, "In order to redirect the input stream, the user must use the reserved character: ");
+        strcat(h_general, _FORMAT_BOLD_);
+        strcat(h_general, "<");
+        strcat(h_general, _FORMAT_RESET_ALL_);
+        strcat(h_general, _FG_COLOR_WHITE_);
+        strcat(h_general, "\nfollowed by the file name. The same goes to the output stream redirection, but with\n");
+        strcat(h_general, "its corresponding reserved character: ");
         strcat(h_general, _FORMAT_BOLD_);
-        strcat(h_general, "/redir/stdin");
+        strcat(h_general, ">");
         strcat(h_general, _FORMAT_RESET_ALL_);
         strcat(h_general, _FG_COLOR_WHITE_);
-        strcat(h_general, " and new stdout streams will be\nsearched only in ");
+        strcat(h_general, " (which truncates the file) or ");
         strcat(h_general, _FORMAT_BOLD_);
-        strcat(h_general, "/redir/stdout");
+        strcat(h_general, ">>");
         strcat(h_general, _FORMAT_RESET_ALL_);
         strcat(h_general, _FG_COLOR_WHITE_);
-        strcat(h_general, ".\nIn order to redirect the input stream, the user must use the reserved character: ");
+        strcat(h_general, " (which appends to it).\nA number before the operator selects the stream to redirect (e.g. ");
         strcat(h_general, _FORMAT_BOLD_);
-        strcat(h_general, "<");
+        strcat(h_general, "2>");
         strcat(h_general, _FORMAT_RESET_ALL_);
         strcat(h_general, _FG_COLOR_WHITE_);
-        strcat(h_general, "\nfollowed by the file name. The same goes to the output stream redirection, but with\n");
-        strcat(h_general, "its corresponding reserved character: ");
+        strcat(h_general, " for stderr), and\n");
         strcat(h_general, _FORMAT_BOLD_);
-        strcat(h_general, ">");
+        strcat(h_general, "2>&1");
         strcat(h_general, _FORMAT_RESET_ALL_);
         strcat(h_general, _FG_COLOR_WHITE_);
+        strcat(h_general, " sends stderr wherever stdout goes.\nRedirections are applied from left to right");
         strcat(h_general, ".\n\n");
         strcat(h_general, _FORMAT_BOLD_);
         strcat(h_general, "//////////////////////////////////////////////////////////////////////////////////////\n\n");
@@ -296,10 +344,10 @@ void show_help(int h_type)
     }
     else
     {
-        // + 1556 por el largo del mensaje
+        // + 1683 por el largo del mensaje
         char *h_examples = malloc((strlen(_FORMAT_BOLD_) * 30) + (strlen(_FORMAT_RESET_ALL_) * 30) +
                                   (strlen(_FG_COLOR_WHITE_) * 30) + (strlen(_BG_COLOR_LGRAY_) * 2) +
-                                  sizeof(NULL) + (sizeof(char) * 1556));
+                                  sizeof(NULL) + (sizeof(char) * 1683));
 
         if (!h_examples)
             show_err("Could not allocate memory for message", _FATAL_ERR_);
@@ -335,7 +383,7 @@ void show_help(int h_type)
         strcat(h_examples, "BATCHFILES EXAMPLES\n\n");
         strcat(h_examples, _FORMAT_RESET_ALL_);
         strcat(h_examples, _FG_COLOR_WHITE_);
-        strcat(h_examples, "./bin/myshell batchfile_name\n\n");
+        strcat(h_examples, "./bin/myshell batchfile_name\n./bin/myshell -t batchfile_name\n./bin/myshell path/to/script.sh\n./bin/myshell -c \"ls -l | wc -l\"\ncat script.sh | ./bin/myshell\n\n");
         strcat(h_examples, _FORMAT_BOLD_);
         strcat(h_examples, "//////////////////////////////////////////////////////////////////////////////////////\n\n");
         strcat(h_examples, "BACKGROUND EXECUTION EXAMPLES\n\nman strtok ");
@@ -469,236 +517,3 @@ void show_help(int h_type)
         try_write(STDOUT_FILENO, h_examples);
     }
 }
-
-/**
- * @brief Esta función se encarga de setear las flags
- *        correspondientes a las funcionalidades de
- *        la shell.
- *
- * @param input Input de usuario a analizar.
- *
- * @returns Si no hubo problema al setear las flags, se
- *          retorna 0. En caso de falla, se retorna -1.
- */
-int set_flags(char *input)
-{
-    bg_flag = false;
-    cd_flag = false;
-    clr_flag = false;
-    echo_flag = false;
-    pipe_flag = false;
-    quit_flag = false;
-    redirect_stdin_flag = false;
-    redirect_stdout_flag = false;
-
-    if (regexec(&cd_regex, input, 0, NULL, 0) == 0)
-        cd_flag = true;
-
-    if (regexec(&clr_regex, input, 0, NULL, 0) == 0)
-        clr_flag = true;
-
-    if (regexec(&echo_regex, input, 0, NULL, 0) == 0)
-        echo_flag = true;
-
-    if (regexec(&pipe_regex, input, 0, NULL, 0) == 0)
-        pipe_flag = true;
-
-    if (regexec(&quit_regex, input, 0, NULL, 0) == 0)
-        quit_flag = true;
-
-    if (regexec(&bg_regex, input, 0, NULL, 0) == 0)
-    {
-        if (!(cd_flag || clr_flag || quit_flag || echo_flag || pipe_flag))
-            bg_flag = true;
-        else
-        {
-            show_err("Invalid background execution command", _NORM_ERR_);
-
-            return -1;
-        }
-    }
-
-    if (strstr(input, "<"))
-        redirect_stdin_flag = true;
-
-    if (strstr(input, ">"))
-        redirect_stdout_flag = true;
-
-    if (redirect_stdin_flag)
-    {
-        strtok(input, "<"); /* No hace falta chequear si strtok devuelve NULL porque
-                               la flag está levantada y strstr no modifica el input. */
-        strcpy(new_stdin_name, base_cwd);
-        strcat(new_stdin_name, "/redir/stdin/");
-
-        char *temp_s = strtok(NULL, " \t>");
-
-        if (!temp_s)
-        {
-            show_err("Invalid STDIN redirection input", _NORM_ERR_);
-
-            return -1;
-        }
-
-        strcat(new_stdin_name, chop_to_char(temp_s, "\n"));
-    }
-
-    if (redirect_stdout_flag)
-    {
-        strtok(input, ">");
-
-        strcpy(new_stdout_name, base_cwd);
-        strcat(new_stdout_name, "/redir/stdout/");
-
-        char *temp_s = strtok(NULL, " \t");
-
-        if (!temp_s)
-        {
-            show_err("Invalid STDOUT redirection input", _NORM_ERR_);
-
-            return -1;
-        }
-
-        strcat(new_stdout_name, chop_to_char(temp_s, "\n"));
-    }
-
-    return 0;
-}
-
-/**
- * @brief Esta función recopila el nombre, el path y los argumentos de
- *        un programa a ejecutar.
- *
- * @param input Input del usuario, donde está toda la información del
- *              programa a ejecutar.
- *
- * @returns Si se pudo recopilar la información correctamente.
- */
-bool get_prog_data(char *input)
-{
-    args_amount = 1;
-
-    prog_path = malloc(strlen(getenv("PATH"))); // Directorio actual de búsqueda
-
-    if (!prog_path)
-        show_err("Could not allocate memory for program path", _FATAL_ERR_);
-
-    prog_args = (char **)malloc(sizeof(char *) + sizeof(NULL)); /* Espacio mínimo necesario por el nombre
-                                                                   y el argumento NULL. */
-
-    if (!prog_args)
-        show_err("Could not allocate memory for program arguments", _FATAL_ERR_);
-
-    strcpy(aux_input, input);
-
-    /*
-        Si el input comienza con "./", hace referencia a un path relativo.
-        Si el input comienza con "/", hace referencia a un path absoluto.
-        De lo contrario, hace referencia a un programa estándar a buscar en $PATH.
-    */
-    if (aux_input[0] == '.' && aux_input[1] == '/')
-        prog_type = _REL_;
-    else if (aux_input[0] == '/')
-        prog_type = _ABS_;
-    else
-        prog_type = _STD_;
-
-    /*
-        Si hay un espacio o tabulación en el input, significa que además
-        de proporcionar el nombre del programa, el usuario ingresó
-        argumentos. De lo contrario, el argumento es NULL.
-        Se reserva memoria de manera dinámica para almacenar los
-        argumentos recibidos para el programa.
-    */
-    if (strstr(aux_input, " ") || strstr(aux_input, "\t"))
-    {
-        prog_name = strtok(aux_input, " \t");
-
-        prog_args[0] = (char *)malloc(strlen(prog_name) + sizeof(NULL));
-
-        if (!prog_args[0])
-        {
-            show_err("Could not allocate memory for program arguments", _NORM_ERR_);
-
-            free(prog_args);
-
-            return false;
-        }
-
-        strcpy(prog_args[0], prog_name); // Siempre el primer argumento para el programa será el nombre del programa
-
-        char *aux_arg = strtok(NULL, " \t"); // Porción del input a evaluar si es argumento
-
-        while ((aux_arg != NULL) &&
-               (strcmp(aux_arg, "<") != 0) && (strcmp(aux_arg, ">") != 0) &&
-               (strcmp(aux_arg, "&") != 0) && (strcmp(aux_arg, "|") != 0))
-        {
-            aux_arg = strtrim(aux_arg);
-
-            char **aux_prog_args = (char **)realloc(prog_args, (((1 + args_amount) * sizeof(char *)) + sizeof(NULL)));
-
-            if (aux_prog_args == NULL)
-            {
-                show_err("Could not reallocate memory for program arguments", _NORM_ERR_);
-
-                free(prog_args);
-
-                return false;
-            }
-
-            prog_args = aux_prog_args;
-
-            prog_args[args_amount] = (char *)malloc(strlen(aux_arg) + sizeof(NULL));
-
-            if (!prog_args[args_amount])
-            {
-                show_err("Could not allocate memory for program arguments", _NORM_ERR_);
-
-                free(prog_args);
-
-                return false;
-            }
-
-            strcpy(prog_args[args_amount], chop_to_char(aux_arg, "\n"));
-
-            args_amount++;
-
-            aux_arg = strtok(NULL, " \t");
-        }
-    }
-    else
-    {
-        prog_name = strtok(aux_input, "\n");
-
-        prog_args[0] = (char *)malloc(strlen(prog_name) + sizeof(NULL));
-
-        if (!prog_args[0])
-        {
-            show_err("Could not reallocate memory for program arguments", _NORM_ERR_);
-
-            free(prog_args);
-
-            return false;
-        }
-
-        strcpy(prog_args[0], prog_name);
-    }
-
-    prog_args[args_amount] = NULL; // Siempre el último argumento para el programa será NULL
-
-    if (prog_type == _REL_)
-    {
-        prog_name = strtok(prog_name, ".");
-
-        chop_to_char(prog_name, "\n");
-
-        strcpy(prog_path, getenv("PWD"));
-
-        strcat(prog_path, "/");
-        strcat(prog_path, prog_name);
-    }
-    else if (prog_type == _ABS_)
-        strcpy(prog_path, chop_to_char(input, "\n"));
-
-    return true;
-}
\ No newline at end of file
@@ -0,0 +1,200 @@
+/**
+ * @file stats.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con los contadores y las mediciones de
+ *        latencia internas de la shell (comando 'shstat').
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/stats.h"
+
+/**
+ * @brief Esta función calcula el intervalo del histograma que
+ *        corresponde a una latencia.
+ *
+ * @details Los valores menores a 2^_HIST_SUB_BITS_ tienen su propio
+ *          intervalo. El resto se ubica según su bit más significativo
+ *          y los _HIST_SUB_BITS_ bits siguientes.
+ *
+ * @param ns Latencia en nanosegundos.
+ *
+ * @returns El índice del intervalo.
+ */
+static int bucket_of(uint64_t ns)
+{
+    if (ns < (1 << _HIST_SUB_BITS_))
+        return (int)ns;
+
+    int msb = 63 - __builtin_clzll(ns);
+    int sub = (int)(ns >> (msb - _HIST_SUB_BITS_)) & ((1 << _HIST_SUB_BITS_) - 1);
+
+    return ((msb - _HIST_SUB_BITS_ + 1) << _HIST_SUB_BITS_) | sub;
+}
+
+/**
+ * @brief Esta función calcula el mayor valor de un intervalo
+ *        del histograma.
+ *
+ * @param bucket Índice del intervalo.
+ *
+ * @returns El mayor valor del intervalo, en nanosegundos.
+ */
+static uint64_t bucket_top(int bucket)
+{
+    if (bucket < (1 << _HIST_SUB_BITS_))
+        return (uint64_t)bucket;
+
+    int shift = (bucket >> _HIST_SUB_BITS_) - 1;
+    uint64_t low = ((uint64_t)((1 << _HIST_SUB_BITS_) | (bucket & ((1 << _HIST_SUB_BITS_) - 1)))) << shift;
+
+    return low + (((uint64_t)1 << shift) - 1);
+}
+
+/**
+ * @brief Esta función estima un percentil de las latencias de una fase.
+ *
+ * @details Se devuelve el mayor valor del intervalo del histograma en
+ *          el que se alcanza el percentil, acotado por el máximo medido,
+ *          de modo que la estimación nunca queda por debajo del valor real.
+ *
+ * @param ph Fase a analizar.
+ * @param percent Percentil buscado (entre 0 y 100).
+ *
+ * @returns El percentil en nanosegundos.
+ */
+static uint64_t percentile(phase_stat *ph, int percent)
+{
+    if (ph->count == 0)
+        return 0;
+
+    uint64_t rank = ((ph->count * percent) + 99) / 100;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < _HIST_BUCKETS_; i++)
+        if ((seen += ph->hist[i]) >= rank)
+        {
+            uint64_t top = bucket_top(i);
+
+            return (top < ph->max_ns) ? top : ph->max_ns;
+        }
+
+    return ph->max_ns;
+}
+
+/**
+ * @brief Esta función reinicia todos los contadores y mediciones.
+ *
+ * @details Antes se vacía el buffer de salida, para que lo que ya
+ *          escribieron los comandos internos no se cuente después.
+ */
+void stats_reset(void)
+{
+    out_flush();
+
+    memset(&sh_stats, 0, sizeof(sh_stats));
+
+    out_bytes = 0;
+}
+
+/**
+ * @brief Esta función muestra los contadores y las mediciones de
+ *        latencia de la shell.
+ *
+ * @details Por cada fase se muestra la cantidad de mediciones, el
+ *          tiempo total y medio, los percentiles 50 y 99 y el máximo,
+ *          todos en nanosegundos. La fase 'overhead' es el tiempo que
+ *          la shell agrega a cada línea: todo lo que tarda en analizarla
+ *          y ejecutarla, salvo la espera de los procesos.
+ *
+ * @param json Si se muestra como un objeto JSON en lugar de una tabla.
+ */
+void stats_show(bool json)
+{
+    static char *names[_PHASES_AMOUNT_] = { "read", "parse", "prepare", "redirect", "launch", "wait", "overhead" };
+
+    char line[1024];
+
+    if (json)
+        snprintf(line, sizeof(line),
+                 "{\"commands\":%" PRIu64 ",\"builtins\":%" PRIu64 ",\"spawns\":%" PRIu64 ",\"forks\":%" PRIu64
+                 ",\"failed_execs\":%" PRIu64 ",\"parse_errors\":%" PRIu64 ",\"builtin_out_bytes\":%llu"
+                 ",\"pipes\":%" PRIu64 ",\"pipe_size\":%" PRIu64 ",\"pipe_resize_errors\":%" PRIu64 ",\"phases\":{",
+                 sh_stats.commands, sh_stats.builtins, sh_stats.spawns, sh_stats.forks,
+                 sh_stats.failed_execs, sh_stats.parse_errors, out_bytes,
+                 sh_stats.pipes, sh_stats.pipe_size, sh_stats.pipe_resize_errors);
+    else
+        snprintf(line, sizeof(line),
+                 "commands           %" PRIu64 "\nbuiltins           %" PRIu64 "\nspawns             %" PRIu64
+                 "\nforks              %" PRIu64 "\nfailed execs       %" PRIu64 "\nparse errors       %" PRIu64
+                 "\nbuiltin out bytes  %llu\npipes              %" PRIu64 "\npipe size          %" PRIu64
+                 "\npipe resize errors %" PRIu64
+                 "\n\nphase          count       total ns      mean ns       p50 ns       p99 ns       max ns\n",
+                 sh_stats.commands, sh_stats.builtins, sh_stats.spawns, sh_stats.forks,
+                 sh_stats.failed_execs, sh_stats.parse_errors, out_bytes,
+                 sh_stats.pipes, sh_stats.pipe_size, sh_stats.pipe_resize_errors);
+
+    out_write(line);
+
+    for (int i = 0; i < _PHASES_AMOUNT_; i++)
+    {
+        phase_stat *ph = &sh_stats.phases[i];
+
+        uint64_t mean = ph->count ? (ph->total_ns / ph->count) : 0;
+
+        if (json)
+            snprintf(line, sizeof(line),
+                     "%s\"%s\":{\"count\":%" PRIu64 ",\"total_ns\":%" PRIu64 ",\"mean_ns\":%" PRIu64
+                     ",\"p50_ns\":%" PRIu64 ",\"p99_ns\":%" PRIu64 ",\"max_ns\":%" PRIu64 "}",
+                     i ? "," : "", names[i], ph->count, ph->total_ns, mean,
+                     percentile(ph, 50), percentile(ph, 99), ph->max_ns);
+        else
+            snprintf(line, sizeof(line),
+                     "%-9s %10" PRIu64 " %14" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+                     names[i], ph->count, ph->total_ns, mean,
+                     percentile(ph, 50), percentile(ph, 99), ph->max_ns);
+
+        out_write(line);
+    }
+
+    if (json)
+        out_write("}}\n");
+}
+
+/**
+ * @brief Esta función devuelve el instante actual para medir latencias.
+ *
+ * @returns El valor del reloj monotónico, en nanosegundos.
+ */
+uint64_t stat_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Esta función registra una medición de una fase.
+ *
+ * @param phase Fase medida.
+ * @param start Instante en el que comenzó la fase (según stat_now).
+ *
+ * @returns La duración de la fase, en nanosegundos.
+ */
+uint64_t stat_phase(int phase, uint64_t start)
+{
+    phase_stat *ph = &sh_stats.phases[phase];
+
+    uint64_t ns = stat_now() - start;
+
+    ph->count++;
+    ph->total_ns += ns;
+    ph->hist[bucket_of(ns)]++;
+
+    if (ns > ph->max_ns)
+        ph->max_ns = ns;
+
+    return ns;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file timing.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con la medición de los recursos consumidos
+ *        por los comandos (palabra clave 'time').
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/timing.h"
+
+/**
+ * @brief Esta función escribe un string como string de JSON,
+ *        entre comillas y con los caracteres especiales escapados.
+ *
+ * @param out Donde se escribe (al menos 6 * strlen(str) + 3 bytes).
+ * @param str String a escribir.
+ *
+ * @returns La cantidad de caracteres escritos.
+ */
+static int json_str(char *out, char *str)
+{
+    char *start = out;
+
+    *out++ = '"';
+
+    for (unsigned char *c = (unsigned char *)str; *c; c++)
+        if ((*c == '"') || (*c == '\\'))
+        {
+            *out++ = '\\';
+            *out++ = *c;
+        }
+        else if (*c < 0x20)
+            out += sprintf(out, "\\u%04x", *c);
+        else
+            *out++ = *c;
+
+    *out++ = '"';
+    *out = '\0';
+
+    return out - start;
+}
+
+/**
+ * @brief Esta función escribe los recursos consumidos por una
+ *        etapa (o por el total) en el formato indicado.
+ *
+ * @param out Donde se escribe.
+ * @param format _TIME_HUMAN_ o _TIME_JSON_.
+ * @param st Etapa a escribir.
+ *
+ * @returns La cantidad de caracteres escritos.
+ */
+static int usage_str(char *out, int format, stage_time *st)
+{
+    struct rusage *u = &st->usage;
+
+    if (format == _TIME_JSON_)
+        return sprintf(out, "\"status\":%d,\"real\":%.6f,\"user\":%.6f,\"sys\":%.6f,\"maxrss_kb\":%ld,"
+                            "\"nvcsw\":%ld,\"nivcsw\":%ld,\"majflt\":%ld,\"minflt\":%ld",
+                       st->status, st->real, tv_secs(&u->ru_utime), tv_secs(&u->ru_stime), u->ru_maxrss,
+                       u->ru_nvcsw, u->ru_nivcsw, u->ru_majflt, u->ru_minflt);
+
+    return sprintf(out, "%6d %9.3f %9.3f %9.3f %10ld %7ld %7ld %7ld %8ld  ",
+                   st->status, st->real, tv_secs(&u->ru_utime), tv_secs(&u->ru_stime), u->ru_maxrss,
+                   u->ru_nvcsw, u->ru_nivcsw, u->ru_majflt, u->ru_minflt);
+}
+
+/**
+ * @brief Esta función muestra los recursos consumidos por un comando
+ *        medido con 'time', por stderr y en el formato de time_format.
+ *
+ * @details Se muestra una fila por etapa, para identificar cuál es el
+ *          cuello de botella de un pipeline, y una fila con el total:
+ *          el tiempo real de todo el comando, la suma de los tiempos
+ *          de CPU, cambios de contexto y fallos de página, y el máximo
+ *          de memoria residente de las etapas. El código de salida del
+ *          total es el de la última etapa.
+ *          Los tiempos de CPU y la memoria se expresan en segundos y
+ *          en KiB, tal como los devuelve el kernel.
+ *
+ * @param cmd Línea de comandos medida.
+ * @param stages Recursos consumidos por cada etapa.
+ * @param stages_amount Cantidad de etapas.
+ * @param real Segundos que tardó el comando completo.
+ */
+void time_report(char *cmd, stage_time *stages, int stages_amount, double real)
+{
+    stage_time total;
+
+    memset(&total, 0, sizeof(total));
+
+    total.real = real;
+    total.status = stages_amount ? stages[stages_amount - 1].status : EXIT_SUCCESS;
+
+    size_t len = 512 + (6 * strlen(cmd));
+
+    for (int i = 0; i < stages_amount; i++)
+    {
+        struct rusage *u = &stages[i].usage;
+
+        timeradd(&total.usage.ru_utime, &u->ru_utime, &total.usage.ru_utime);
+        timeradd(&total.usage.ru_stime, &u->ru_stime, &total.usage.ru_stime);
+
+        if (u->ru_maxrss > total.usage.ru_maxrss)
+            total.usage.ru_maxrss = u->ru_maxrss;
+
+        total.usage.ru_nvcsw += u->ru_nvcsw;
+        total.usage.ru_nivcsw += u->ru_nivcsw;
+        total.usage.ru_majflt += u->ru_majflt;
+        total.usage.ru_minflt += u->ru_minflt;
+
+        len += 384 + (6 * strlen(stages[i].name));
+    }
+
+    char *report = (char *)malloc(len);
+    char *out = report;
+
+    if (!report)
+        show_err("Could not allocate memory for time report", _FATAL_ERR_);
+
+    if (time_format == _TIME_POSIX_)
+        sprintf(out, "real %.2f\nuser %.2f\nsys %.2f\n",
+                real, tv_secs(&total.usage.ru_utime), tv_secs(&total.usage.ru_stime));
+    else if (time_format == _TIME_JSON_)
+    {
+        out += sprintf(out, "{\"command\":");
+        out += json_str(out, cmd);
+        out += sprintf(out, ",");
+        out += usage_str(out, _TIME_JSON_, &total);
+        out += sprintf(out, ",\"stages\":[");
+
+        for (int i = 0; i < stages_amount; i++)
+        {
+            out += sprintf(out, "%s{\"name\":", i ? "," : "");
+            out += json_str(out, stages[i].name);
+            out += sprintf(out, ",\"pid\":%d,", stages[i].pid);
+            out += usage_str(out, _TIME_JSON_, &stages[i]);
+            out += sprintf(out, "}");
+        }
+
+        sprintf(out, "]}\n");
+    }
+    else
+    {
+        out += sprintf(out, "stage    pid    status      real      user       sys maxrss KiB    vcsw   ivcsw  majflt   minflt  command\n");
+
+        for (int i = 0; i < stages_amount; i++)
+        {
+            out += sprintf(out, "%-5d %7d ", i + 1, stages[i].pid);
+            out += usage_str(out, _TIME_HUMAN_, &stages[i]);
+            out += sprintf(out, "%s\n", stages[i].name);
+        }
+
+        out += sprintf(out, "total %7s ", "");
+        out += usage_str(out, _TIME_HUMAN_, &total);
+
+        sprintf(out, "%s\n", cmd);
+    }
+
+    // El reporte no debe mezclarse con la salida pendiente del comando
+    out_flush();
+
+    try_write(STDERR_FILENO, report);
+
+    free(report);
+}
+
+/**
+ * @brief Esta función calcula el tiempo transcurrido entre dos instantes.
+ *
+ * @param start Instante inicial.
+ * @param end Instante final.
+ *
+ * @returns El tiempo transcurrido en segundos.
+ */
+double ts_diff(struct timespec *start, struct timespec *end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/**
+ * @brief Esta función convierte un tiempo de CPU a segundos.
+ *
+ * @param tv Tiempo a convertir.
+ *
+ * @returns El tiempo en segundos.
+ */
+double tv_secs(struct timeval *tv)
+{
+    return (double)tv->tv_sec + ((double)tv->tv_usec / 1e6);
+}
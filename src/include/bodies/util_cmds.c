@@ -0,0 +1,1527 @@
+/**
+ * @file util_cmds.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con los comandos internos de utilidades,
+ *        que se ejecutan sin crear procesos.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/util_cmds.h"
+
+static const struct
+{
+    char *name;
+
+    int number;
+} signals[] = {
+    { "HUP", SIGHUP },
+    { "INT", SIGINT },
+    { "QUIT", SIGQUIT },
+    { "KILL", SIGKILL },
+    { "USR1", SIGUSR1 },
+    { "USR2", SIGUSR2 },
+    { "PIPE", SIGPIPE },
+    { "ALRM", SIGALRM },
+    { "TERM", SIGTERM },
+    { "CHLD", SIGCHLD },
+    { "CONT", SIGCONT },
+    { "STOP", SIGSTOP },
+    { "TSTP", SIGTSTP },
+    { "TTIN", SIGTTIN },
+    { "TTOU", SIGTTOU },
+    { "WINCH", SIGWINCH }
+};
+
+static char **test_args; // Argumentos de 'test' que se están evaluando
+
+static int test_amount;
+static int test_pos;
+
+static bool test_failed; // Si la expresión de 'test' tiene errores
+
+static volatile sig_atomic_t sleep_interrupted;
+
+/**
+ * @brief Esta función escribe el caracter correspondiente a una
+ *        secuencia de escape de 'printf'.
+ *
+ * @param out Stream donde se escribe.
+ * @param c Caracter que sigue a '\'.
+ *
+ * @returns Cantidad de caracteres de la secuencia, sin contar '\'.
+ */
+static int printf_escape(FILE *out, char *c)
+{
+    static const char from[] = "abfnrtv\\\"'";
+    static const char to[] = "\a\b\f\n\r\t\v\\\"'";
+
+    char *match = (*c != '\0') ? strchr(from, *c) : NULL;
+
+    if (match)
+    {
+        fputc(to[match - from], out);
+
+        return 1;
+    }
+
+    // Octal: \0NNN en los argumentos de '%b' y \NNN en el formato
+    if ((*c >= '0') && (*c <= '7'))
+    {
+        int value = 0;
+        int len = 0;
+
+        while ((len < 3 + (*c == '0')) && (c[len] >= '0') && (c[len] <= '7'))
+            value = (value * 8) + (c[len++] - '0');
+
+        fputc(value & 0xff, out);
+
+        return len;
+    }
+
+    fputc('\\', out);
+
+    return 0;
+}
+
+/**
+ * @brief Esta función obtiene un argumento numérico de 'printf'.
+ *
+ * @details Un argumento que comienza con una comilla toma el valor del
+ *          caracter que la sigue, como en 'printf' de POSIX.
+ *
+ * @param arg Argumento, o NULL si ya no quedan.
+ * @param value Donde se guarda el valor.
+ *
+ * @returns Si el argumento es un número válido.
+ */
+static bool printf_number(char *arg, long long *value)
+{
+    char *end;
+
+    if (!arg || (*arg == '\0'))
+    {
+        *value = 0;
+
+        return true;
+    }
+
+    if ((*arg == '\'') || (*arg == '"'))
+    {
+        *value = (unsigned char)arg[1];
+
+        return true;
+    }
+
+    errno = 0;
+
+    *value = strtoll(arg, &end, 0);
+
+    // Los valores sin signo demasiado grandes para long long
+    if ((errno == ERANGE) && (*arg != '-'))
+    {
+        errno = 0;
+
+        *value = (long long)strtoull(arg, &end, 0);
+    }
+
+    return (*end == '\0') && (errno == 0);
+}
+
+/**
+ * @brief Esta función aplica una vez el formato de 'printf'.
+ *
+ * @param out Stream donde se escribe.
+ * @param fmt Formato.
+ * @param arg Próximo argumento a consumir. Se avanza por cada uno que
+ *            se consume.
+ *
+ * @returns Si el formato se aplicó sin errores.
+ */
+static bool printf_apply(FILE *out, char *fmt, char ***arg)
+{
+    bool ok = true;
+
+    for (char *c = fmt; *c; c++)
+    {
+        if (*c == '\\')
+        {
+            c += printf_escape(out, c + 1);
+
+            continue;
+        }
+
+        if (*c != '%')
+        {
+            fputc(*c, out);
+
+            continue;
+        }
+
+        if (c[1] == '%')
+        {
+            fputc('%', out);
+
+            c++;
+
+            continue;
+        }
+
+        // Especificación: %[flags][ancho][.precisión]conversión
+        char spec[64] = "%";
+
+        size_t len = 1;
+
+        int stars[2];
+        int stars_amount = 0;
+
+        for (c++; *c && strchr("-+ #0", *c) && (len < 16); c++)
+            spec[len++] = *c;
+
+        for (int part = 0; part < 2; part++)
+        {
+            if (*c == '*')
+            {
+                long long value;
+
+                if (!printf_number(**arg, &value))
+                    ok = false;
+
+                if (**arg)
+                    (*arg)++;
+
+                stars[stars_amount++] = (int)value;
+
+                spec[len++] = '*';
+
+                c++;
+            }
+            else
+                for (; (*c >= '0') && (*c <= '9') && (len < 40); c++)
+                    spec[len++] = *c;
+
+            if ((part == 0) && (*c == '.'))
+                spec[len++] = *c++;
+            else
+                break;
+        }
+
+        char conv = *c;
+
+        char *value = **arg;
+
+        if (conv && strchr("diouxXeEfFgGcsb", conv) && value)
+            (*arg)++;
+
+        switch (conv)
+        {
+            case 'd':
+            case 'i':
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+            {
+                long long number;
+
+                if (!printf_number(value, &number))
+                {
+                    show_err("printf: invalid number", _NORM_ERR_);
+
+                    ok = false;
+                }
+
+                spec[len++] = 'l';
+                spec[len++] = 'l';
+                spec[len++] = conv;
+                spec[len] = '\0';
+
+                if (stars_amount == 2)
+                    fprintf(out, spec, stars[0], stars[1], number);
+                else if (stars_amount == 1)
+                    fprintf(out, spec, stars[0], number);
+                else
+                    fprintf(out, spec, number);
+
+                break;
+            }
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            {
+                char *end = "";
+
+                double number = value ? strtod(value, &end) : 0;
+
+                if (*end != '\0')
+                {
+                    show_err("printf: invalid number", _NORM_ERR_);
+
+                    ok = false;
+                }
+
+                spec[len++] = conv;
+                spec[len] = '\0';
+
+                if (stars_amount == 2)
+                    fprintf(out, spec, stars[0], stars[1], number);
+                else if (stars_amount == 1)
+                    fprintf(out, spec, stars[0], number);
+                else
+                    fprintf(out, spec, number);
+
+                break;
+            }
+
+            case 'c':
+            case 's':
+            {
+                spec[len++] = conv;
+                spec[len] = '\0';
+
+                if (conv == 'c')
+                {
+                    if (value && (*value != '\0'))
+                        fputc(*value, out);
+
+                    break;
+                }
+
+                if (!value)
+                    value = "";
+
+                if (stars_amount == 2)
+                    fprintf(out, spec, stars[0], stars[1], value);
+                else if (stars_amount == 1)
+                    fprintf(out, spec, stars[0], value);
+                else
+                    fprintf(out, spec, value);
+
+                break;
+            }
+
+            case 'b':
+            {
+                for (char *v = value ? value : ""; *v; v++)
+                    if (*v == '\\')
+                        v += printf_escape(out, v + 1);
+                    else
+                        fputc(*v, out);
+
+                break;
+            }
+
+            default:
+            {
+                show_err("printf: invalid format", _NORM_ERR_);
+
+                return false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Esta función indica si un argumento de 'test' es un
+ *        operador binario.
+ *
+ * @param arg Argumento a analizar.
+ *
+ * @returns Si el argumento es un operador binario.
+ */
+static bool test_binary_op(char *arg)
+{
+    static char *ops[] = { "=", "==", "!=", "<", ">", "-eq", "-ne", "-lt", "-le", "-gt", "-ge", "-nt", "-ot", "-ef" };
+
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++)
+        if (strcmp(arg, ops[i]) == 0)
+            return true;
+
+    return false;
+}
+
+/**
+ * @brief Esta función obtiene un operando entero de 'test'.
+ *
+ * @param arg Operando.
+ *
+ * @returns El valor del operando, o 0 si no es un entero (y se
+ *          marca el error).
+ */
+static long long test_integer(char *arg)
+{
+    char *end;
+
+    while ((*arg == ' ') || (*arg == '\t'))
+        arg++;
+
+    errno = 0;
+
+    long long value = strtoll(arg, &end, 10);
+
+    while ((*end == ' ') || (*end == '\t'))
+        end++;
+
+    if ((end == arg) || (*end != '\0') || (errno != 0))
+    {
+        show_err("test: integer expression expected", _NORM_ERR_);
+
+        test_failed = true;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Esta función evalúa un operador unario de 'test'.
+ *
+ * @param op Operador.
+ * @param arg Operando.
+ *
+ * @returns El resultado de la comparación.
+ */
+static bool test_unary(char *op, char *arg)
+{
+    struct stat st;
+
+    if (strcmp(op, "-n") == 0)
+        return *arg != '\0';
+
+    if (strcmp(op, "-z") == 0)
+        return *arg == '\0';
+
+    if (strcmp(op, "-t") == 0)
+        return isatty((int)test_integer(arg));
+
+    if ((strcmp(op, "-L") == 0) || (strcmp(op, "-h") == 0))
+        return (lstat(arg, &st) == 0) && S_ISLNK(st.st_mode);
+
+    if (strcmp(op, "-r") == 0)
+        return access(arg, R_OK) == 0;
+
+    if (strcmp(op, "-w") == 0)
+        return access(arg, W_OK) == 0;
+
+    if (strcmp(op, "-x") == 0)
+        return access(arg, X_OK) == 0;
+
+    if (stat(arg, &st) == -1)
+        return false;
+
+    switch (op[1])
+    {
+        case 'e':
+            return true;
+
+        case 'f':
+            return S_ISREG(st.st_mode);
+
+        case 'd':
+            return S_ISDIR(st.st_mode);
+
+        case 's':
+            return st.st_size > 0;
+
+        case 'b':
+            return S_ISBLK(st.st_mode);
+
+        case 'c':
+            return S_ISCHR(st.st_mode);
+
+        case 'p':
+            return S_ISFIFO(st.st_mode);
+
+        default:
+            return S_ISSOCK(st.st_mode); // -S
+    }
+}
+
+/**
+ * @brief Esta función indica si un argumento de 'test' es un
+ *        operador unario.
+ *
+ * @param arg Argumento a analizar.
+ *
+ * @returns Si el argumento es un operador unario.
+ */
+static bool test_unary_op(char *arg)
+{
+    return (arg[0] == '-') && arg[1] && (arg[2] == '\0') && strchr("nztLhrwxefdsbcpS", arg[1]);
+}
+
+/**
+ * @brief Esta función evalúa un operador binario de 'test'.
+ *
+ * @param left Operando izquierdo.
+ * @param op Operador.
+ * @param right Operando derecho.
+ *
+ * @returns El resultado de la comparación.
+ */
+static bool test_binary(char *left, char *op, char *right)
+{
+    if ((strcmp(op, "=") == 0) || (strcmp(op, "==") == 0))
+        return strcmp(left, right) == 0;
+
+    if (strcmp(op, "!=") == 0)
+        return strcmp(left, right) != 0;
+
+    if (strcmp(op, "<") == 0)
+        return strcmp(left, right) < 0;
+
+    if (strcmp(op, ">") == 0)
+        return strcmp(left, right) > 0;
+
+    if ((op[1] == 'n') || (op[1] == 'o') || (strcmp(op, "-ef") == 0))
+    {
+        struct stat l, r;
+
+        bool l_ok = stat(left, &l) == 0;
+        bool r_ok = stat(right, &r) == 0;
+
+        if (strcmp(op, "-ef") == 0)
+            return l_ok && r_ok && (l.st_dev == r.st_dev) && (l.st_ino == r.st_ino);
+
+        if (strcmp(op, "-ne") != 0)
+        {
+            // -nt y -ot: un archivo inexistente es más antiguo que cualquiera
+            bool newer = l_ok && (!r_ok || (l.st_mtim.tv_sec > r.st_mtim.tv_sec) ||
+                                  ((l.st_mtim.tv_sec == r.st_mtim.tv_sec) && (l.st_mtim.tv_nsec > r.st_mtim.tv_nsec)));
+            bool older = r_ok && (!l_ok || (l.st_mtim.tv_sec < r.st_mtim.tv_sec) ||
+                                  ((l.st_mtim.tv_sec == r.st_mtim.tv_sec) && (l.st_mtim.tv_nsec < r.st_mtim.tv_nsec)));
+
+            return (op[1] == 'n') ? newer : older;
+        }
+    }
+
+    long long l = test_integer(left);
+    long long r = test_integer(right);
+
+    if (strcmp(op, "-eq") == 0)
+        return l == r;
+
+    if (strcmp(op, "-ne") == 0)
+        return l != r;
+
+    if (strcmp(op, "-lt") == 0)
+        return l < r;
+
+    if (strcmp(op, "-le") == 0)
+        return l <= r;
+
+    if (strcmp(op, "-gt") == 0)
+        return l > r;
+
+    return l >= r; // -ge
+}
+
+static bool test_or(void);
+
+/**
+ * @brief Esta función evalúa una expresión primaria de 'test':
+ *        una comparación, una expresión entre paréntesis, una
+ *        negación o un string (verdadero si no es vacío).
+ *
+ * @details Como en POSIX, se prueba primero si el segundo argumento es
+ *          un operador binario, por lo que 'test -n = x' compara strings.
+ *
+ * @returns El resultado de la expresión.
+ */
+static bool test_primary(void)
+{
+    if (test_pos >= test_amount)
+    {
+        show_err("test: argument expected", _NORM_ERR_);
+
+        test_failed = true;
+
+        return false;
+    }
+
+    char *arg = test_args[test_pos];
+
+    if ((test_pos + 2 < test_amount) && test_binary_op(test_args[test_pos + 1]))
+    {
+        test_pos += 3;
+
+        return test_binary(arg, test_args[test_pos - 2], test_args[test_pos - 1]);
+    }
+
+    if ((strcmp(arg, "!") == 0) && (test_pos + 1 < test_amount))
+    {
+        test_pos++;
+
+        return !test_primary();
+    }
+
+    if ((strcmp(arg, "(") == 0) && (test_pos + 1 < test_amount))
+    {
+        test_pos++;
+
+        bool result = test_or();
+
+        if ((test_pos >= test_amount) || (strcmp(test_args[test_pos], ")") != 0))
+        {
+            show_err("test: missing ')'", _NORM_ERR_);
+
+            test_failed = true;
+        }
+
+        test_pos++;
+
+        return result;
+    }
+
+    if (test_unary_op(arg) && (test_pos + 1 < test_amount))
+    {
+        test_pos += 2;
+
+        return test_unary(arg, test_args[test_pos - 1]);
+    }
+
+    test_pos++;
+
+    return *arg != '\0';
+}
+
+/**
+ * @brief Esta función evalúa una conjunción de 'test' (-a).
+ *
+ * @returns El resultado de la expresión.
+ */
+static bool test_and(void)
+{
+    bool result = test_primary();
+
+    while ((test_pos < test_amount) && (strcmp(test_args[test_pos], "-a") == 0))
+    {
+        test_pos++;
+
+        // Se evalúa igual, para detectar los errores de sintaxis
+        bool right = test_primary();
+
+        result = result && right;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Esta función evalúa una disyunción de 'test' (-o), la
+ *        expresión de menor precedencia.
+ *
+ * @returns El resultado de la expresión.
+ */
+static bool test_or(void)
+{
+    bool result = test_and();
+
+    while ((test_pos < test_amount) && (strcmp(test_args[test_pos], "-o") == 0))
+    {
+        test_pos++;
+
+        bool right = test_and();
+
+        result = result || right;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Esta función atiende la signal SIGINT durante 'sleep'.
+ *
+ * @param sig Signal recibida.
+ */
+static void sleep_sigint(int sig)
+{
+    (void)sig;
+
+    sleep_interrupted = 1;
+}
+
+/**
+ * @brief Esta función obtiene el número de una signal a partir de su
+ *        nombre (con o sin "SIG") o de su número.
+ *
+ * @param name Nombre o número de la signal.
+ *
+ * @returns El número de la signal, o -1 si no existe.
+ */
+static int signal_number(char *name)
+{
+    char *end;
+
+    long number = strtol(name, &end, 10);
+
+    if ((*end == '\0') && (end != name))
+        return ((number >= 0) && (number < NSIG)) ? (int)number : -1;
+
+    if (strncmp(name, "SIG", 3) == 0)
+        name += 3;
+
+    for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); i++)
+        if (strcasecmp(name, signals[i].name) == 0)
+            return signals[i].number;
+
+    return -1;
+}
+
+/**
+ * @brief Esta función descarta una salida de 'tee' en la que no se
+ *        pudo escribir.
+ *
+ * @param out Salida a descartar.
+ * @param err Código de error de la escritura.
+ * @param name Nombre de la salida, para el mensaje de error.
+ */
+static void tee_fail(tee_out *out, int err, char *name)
+{
+    // Si el lector de un pipe terminó, no hay nada que informar
+    if (err != EPIPE)
+    {
+        char msg[_STR_MAX_LEN_];
+
+        snprintf(msg, sizeof(msg), "Could not write to %s: %s", name, strerror(err));
+
+        show_err(msg, _NORM_ERR_);
+    }
+
+    if (out->fd != STDOUT_FILENO)
+        close(out->fd);
+
+    out->fd = -1;
+
+    last_status = EXIT_FAILURE;
+}
+
+/**
+ * @brief Esta función escribe por completo un bloque en una salida
+ *        de 'tee'.
+ *
+ * @param fd Destino.
+ * @param data Bloque a escribir.
+ * @param len Largo del bloque.
+ *
+ * @returns Si se pudo escribir todo el bloque. En caso de falla,
+ *          errno indica el motivo.
+ */
+static bool tee_write(int fd, char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t written = write(fd, data, len);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        out_bytes += written;
+
+        data += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Esta función mueve al destino de una salida de 'tee' el
+ *        contenido de su pipe propio.
+ *
+ * @details Se utiliza 'splice', que mueve las páginas del pipe sin
+ *          copiarlas, y que se bloquea mientras el destino esté lleno.
+ *          Si el destino no lo admite (por ejemplo, una terminal o un
+ *          archivo abierto con O_APPEND), desde ese momento se copia
+ *          con 'read' y 'write'.
+ *
+ * @param out Salida a vaciar.
+ * @param len Bytes que contiene su pipe.
+ * @param buffer Buffer para las copias, que se reserva al usarlo por
+ *               primera vez.
+ *
+ * @returns Si se pudo escribir todo el contenido. En caso de falla,
+ *          errno indica el motivo.
+ */
+static bool tee_drain(tee_out *out, size_t len, char **buffer)
+{
+    while (len > 0)
+    {
+        if (!out->copy)
+        {
+            ssize_t moved = splice(out->pipe[0], NULL, out->fd, NULL, len, SPLICE_F_MOVE);
+
+            if (moved > 0)
+            {
+                out_bytes += moved;
+
+                len -= moved;
+            }
+            else if ((moved == -1) && (errno == EINVAL))
+                out->copy = true;
+            else if ((moved == -1) && (errno != EINTR))
+                return false;
+
+            continue;
+        }
+
+        if (!*buffer && !(*buffer = (char *)malloc(_STREAM_BUF_LEN_)))
+            show_err("Could not allocate memory for stream buffer", _FATAL_ERR_);
+
+        ssize_t bytes = read(out->pipe[0], *buffer, (len < _STREAM_BUF_LEN_) ? len : _STREAM_BUF_LEN_);
+
+        if (bytes == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        if (!tee_write(out->fd, *buffer, bytes))
+            return false;
+
+        len -= bytes;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Esta función duplica o mueve el contenido del pipe de
+ *        entrada de 'tee' al pipe propio de una salida.
+ *
+ * @details Como 'tee' no consume la entrada, cada llamada vuelve a
+ *          empezar desde el principio del pipe, por lo que sólo
+ *          'splice' puede continuarse si movió menos de lo pedido.
+ *
+ * @param to Extremo de escritura del pipe propio.
+ * @param len Bytes a duplicar o mover (como máximo, si no es exacto).
+ * @param consume Si se consume la entrada ('splice') o no ('tee').
+ * @param exact Si deben moverse exactamente len bytes.
+ *
+ * @returns Los bytes duplicados o movidos (0 si la entrada terminó),
+ *          o -1 en caso de falla.
+ */
+static ssize_t tee_take(int to, size_t len, bool consume, bool exact)
+{
+    size_t total = 0;
+
+    while (true)
+    {
+        ssize_t moved = consume ? splice(STDIN_FILENO, NULL, to, NULL, len - total, SPLICE_F_MOVE)
+                                : tee(STDIN_FILENO, to, len - total, 0);
+
+        if (moved == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return -1;
+        }
+
+        total += moved;
+
+        if (!consume || !exact || (moved == 0) || (total == len))
+            return total;
+    }
+}
+
+/**
+ * @brief Esta función copia stdin en todas las salidas de 'tee'
+ *        pasando por un buffer, cuando stdin no es un pipe.
+ *
+ * @param outs Salidas de 'tee'.
+ * @param names Nombres de las salidas.
+ * @param amount Cantidad de salidas.
+ * @param buffer Buffer para las copias, que se reserva al usarlo por
+ *               primera vez.
+ */
+static void tee_copy(tee_out *outs, char **names, int amount, char **buffer)
+{
+    if (!*buffer && !(*buffer = (char *)malloc(_STREAM_BUF_LEN_)))
+        show_err("Could not allocate memory for stream buffer", _FATAL_ERR_);
+
+    while (true)
+    {
+        ssize_t bytes = read(STDIN_FILENO, *buffer, _STREAM_BUF_LEN_);
+
+        if ((bytes == -1) && (errno == EINTR))
+            continue;
+
+        if (bytes == -1)
+        {
+            show_err(strerror(errno), _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+        }
+
+        if (bytes <= 0)
+            return;
+
+        for (int i = 0; i < amount; i++)
+            if ((outs[i].fd != -1) && !tee_write(outs[i].fd, *buffer, bytes))
+                tee_fail(&outs[i], errno, names[i]);
+    }
+}
+
+/**
+ * @brief Esta función exporta variables para que las vean los
+ *        programas que lance la shell.
+ *
+ * @details Sintaxis: export [NOMBRE[=valor]...]
+ *          Sin argumentos, se muestran las variables de entorno.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_export(char **args)
+{
+    if (!args[1])
+    {
+        for (char **env = environ; *env; env++)
+        {
+            out_write("export ");
+            out_write(*env);
+            out_write("\n");
+        }
+
+        return;
+    }
+
+    for (int i = 1; args[i]; i++)
+    {
+        char *eq = strchr(args[i], '=');
+
+        size_t len = eq ? (size_t)(eq - args[i]) : strlen(args[i]);
+
+        if (!is_var_name(args[i], len))
+        {
+            show_err("export: invalid variable name", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+
+            continue;
+        }
+
+        char *name = (char *)arena_alloc(&cmd_arena, len + sizeof(NULL));
+
+        memcpy(name, args[i], len);
+
+        name[len] = '\0';
+
+        var_export(name, eq ? eq + 1 : NULL);
+    }
+}
+
+/**
+ * @brief Esta función envía una signal a procesos o trabajos.
+ *
+ * @details Sintaxis: kill [-s SIG | -SIG] pid|%n...
+ *                    kill -l [SIG|código...]
+ *          Por defecto se envía SIGTERM. Los trabajos (%n) reciben la
+ *          signal en todo su grupo de procesos. '-l' sin argumentos lista
+ *          las signals; con argumentos, muestra el nombre de cada número
+ *          (o del código de salida 128 + N de un proceso terminado por
+ *          la signal N) y el número de cada nombre.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_kill(char **args)
+{
+    int sig = SIGTERM;
+    int i = 1;
+
+    if (args[1] && (strcmp(args[1], "-l") == 0))
+    {
+        size_t amount = sizeof(signals) / sizeof(signals[0]);
+
+        if (!args[2])
+        {
+            for (size_t k = 0; k < amount; k++)
+            {
+                out_write(signals[k].name);
+                out_write((k + 1 < amount) ? " " : "\n");
+            }
+
+            return;
+        }
+
+        for (i = 2; args[i]; i++)
+        {
+            char *end;
+            char *name = NULL;
+            char number[16];
+
+            long value = strtol(args[i], &end, 10);
+
+            if ((end != args[i]) && (*end == '\0'))
+            {
+                // Código de salida de un proceso terminado por una signal
+                if (value > 128)
+                    value -= 128;
+
+                for (size_t k = 0; (k < amount) && !name; k++)
+                    if (signals[k].number == value)
+                        name = signals[k].name;
+            }
+            else if ((sig = signal_number(args[i])) != -1)
+            {
+                snprintf(number, sizeof(number), "%d", sig);
+
+                name = number;
+            }
+
+            if (!name)
+            {
+                show_err("kill: invalid signal", _NORM_ERR_);
+
+                last_status = EXIT_FAILURE;
+
+                continue;
+            }
+
+            out_write(name);
+            out_write("\n");
+        }
+
+        return;
+    }
+
+    if (args[1] && (strcmp(args[1], "-s") == 0) && args[2])
+    {
+        sig = signal_number(args[2]);
+
+        i = 3;
+    }
+    else if (args[1] && (args[1][0] == '-') && (strcmp(args[1], "--") != 0) && args[1][1] &&
+             !((args[1][1] >= '0') && (args[1][1] <= '9') && !args[2]))
+    {
+        sig = signal_number(args[1] + 1);
+
+        i = 2;
+    }
+
+    if (args[i] && (strcmp(args[i], "--") == 0))
+        i++;
+
+    if ((sig == -1) || !args[i])
+    {
+        show_err((sig == -1) ? "kill: invalid signal" : "Invalid kill command input", _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+
+        return;
+    }
+
+    for (; args[i]; i++)
+    {
+        bool ok = true;
+
+        if (args[i][0] == '%')
+        {
+            jobs_block();
+
+            job *j = job_find(args[i]);
+
+            if (!j)
+            {
+                show_err("kill: no such job", _NORM_ERR_);
+
+                ok = false;
+            }
+            else if (j->pgid > 0)
+                ok = (kill(-j->pgid, sig) == 0);
+            else
+                for (int k = 0; k < j->procs_amount; k++)
+                    if (!j->procs[k].done && (kill(j->procs[k].pid, sig) == -1))
+                        ok = false;
+
+            jobs_unblock();
+
+            if (!j)
+            {
+                last_status = EXIT_FAILURE;
+
+                continue;
+            }
+        }
+        else
+        {
+            char *end;
+
+            long pid = strtol(args[i], &end, 10);
+
+            if ((*end != '\0') || (end == args[i]))
+            {
+                show_err("kill: invalid process ID", _NORM_ERR_);
+
+                last_status = EXIT_FAILURE;
+
+                continue;
+            }
+
+            ok = (kill((pid_t)pid, sig) == 0);
+        }
+
+        if (!ok)
+        {
+            show_err(strerror(errno), _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+        }
+    }
+}
+
+/**
+ * @brief Esta función muestra texto con formato, como 'printf'.
+ *
+ * @details Sintaxis: printf FORMATO [ARGS...]
+ *          Se soportan las conversiones %d, %i, %o, %u, %x, %X, %e, %f,
+ *          %g, %c, %s y %b (string con secuencias de escape), con flags,
+ *          ancho y precisión (también con '*'), y las secuencias de
+ *          escape de C en el formato. Si sobran argumentos, el formato
+ *          se vuelve a aplicar hasta consumirlos todos.
+ *          La salida se arma completa en memoria y se agrega de una vez
+ *          al buffer de salida de los comandos internos.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_printf(char **args)
+{
+    if (!args[1])
+    {
+        show_err("Invalid printf command input", _NORM_ERR_);
+
+        last_status = 2;
+
+        return;
+    }
+
+    char *text = NULL;
+
+    size_t len = 0;
+
+    FILE *out = open_memstream(&text, &len);
+
+    if (!out)
+        show_err("Could not allocate memory for printf output", _FATAL_ERR_);
+
+    char **arg = &args[2];
+
+    bool ok;
+
+    while (true)
+    {
+        char **before = arg;
+
+        ok = printf_apply(out, args[1], &arg);
+
+        // Se repite el formato sólo si consume argumentos
+        if (!ok || !*arg || (arg == before))
+            break;
+    }
+
+    fclose(out);
+
+    out_nwrite(text, len);
+
+    free(text);
+
+    if (!ok)
+        last_status = EXIT_FAILURE;
+}
+
+/**
+ * @brief Esta función muestra el directorio actual de trabajo.
+ */
+void cmd_pwd(void)
+{
+    out_write(shell_cwd);
+    out_write("\n");
+}
+
+/**
+ * @brief Esta función reemplaza el proceso de la shell por un
+ *        programa, sin crear un proceso nuevo ('exec').
+ *
+ * @details Antes de reemplazar la shell se vacía su buffer de salida
+ *          y se restauran las signals que ignora y la máscara, para que
+ *          el programa las reciba normalmente. Si el programa no puede
+ *          ejecutarse, se vuelve todo a su estado anterior y la shell
+ *          continúa. Sin argumentos, no se hace nada.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_replace(char **args)
+{
+    static const int restored[] = { SIGINT, SIGTSTP, SIGQUIT, SIGTTOU, SIGCHLD };
+
+    struct sigaction old_actions[sizeof(restored) / sizeof(restored[0])];
+
+    sigset_t old_mask;
+    sigset_t empty;
+
+    if (!args[1])
+        return;
+
+    char *path = strchr(args[1], '/') ? args[1] : hash_lookup(args[1]);
+
+    if (!path)
+    {
+        show_err("No such program found", _NORM_ERR_);
+
+        last_status = 127;
+
+        return;
+    }
+
+    out_flush();
+
+    sigemptyset(&empty);
+
+    for (size_t i = 0; i < sizeof(restored) / sizeof(restored[0]); i++)
+    {
+        struct sigaction dfl;
+
+        memset(&dfl, 0, sizeof(dfl));
+
+        dfl.sa_handler = SIG_DFL;
+
+        sigaction(restored[i], &dfl, &old_actions[i]);
+    }
+
+    sigprocmask(SIG_SETMASK, &empty, &old_mask);
+
+    execv(path, &args[1]);
+
+    int error = errno;
+
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+    for (size_t i = 0; i < sizeof(restored) / sizeof(restored[0]); i++)
+        sigaction(restored[i], &old_actions[i], NULL);
+
+    show_err(strerror(error), _NORM_ERR_);
+
+    last_status = 126;
+}
+
+/**
+ * @brief Esta función espera la cantidad de tiempo indicada.
+ *
+ * @details Sintaxis: sleep TIEMPO...
+ *          Cada TIEMPO es un número (con decimales) de segundos, o de
+ *          minutos, horas o días con los sufijos 'm', 'h' o 'd', y se
+ *          espera la suma de todos. La espera se hace en el proceso de
+ *          la shell, por lo que se atiende Ctrl+C (que la shell ignora)
+ *          para poder interrumpirla, con código de salida 130.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_sleep(char **args)
+{
+    double total = 0;
+
+    if (!args[1])
+    {
+        show_err("Invalid sleep command input", _NORM_ERR_);
+
+        last_status = EXIT_FAILURE;
+
+        return;
+    }
+
+    for (int i = 1; args[i]; i++)
+    {
+        char *end;
+
+        double value = strtod(args[i], &end);
+
+        double unit = 1;
+
+        if (*end == 'm')
+            unit = 60;
+        else if (*end == 'h')
+            unit = 3600;
+        else if (*end == 'd')
+            unit = 86400;
+
+        if ((end == args[i]) || (value < 0) || ((*end != '\0') && (end[unit > 1 || *end == 's'] != '\0')))
+        {
+            show_err("Invalid sleep command input", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+
+            return;
+        }
+
+        total += value * unit;
+    }
+
+    struct timespec left;
+
+    left.tv_sec = (time_t)total;
+    left.tv_nsec = (long)((total - (double)left.tv_sec) * 1e9);
+
+    struct sigaction action;
+    struct sigaction old_action;
+
+    memset(&action, 0, sizeof(action));
+
+    action.sa_handler = sleep_sigint;
+
+    sigemptyset(&action.sa_mask);
+
+    sleep_interrupted = 0;
+
+    sigaction(SIGINT, &action, &old_action);
+
+    // SIGCHLD de los trabajos en background también interrumpe la espera
+    while ((nanosleep(&left, &left) == -1) && (errno == EINTR) && !sleep_interrupted)
+        ;
+
+    sigaction(SIGINT, &old_action, NULL);
+
+    if (sleep_interrupted)
+    {
+        out_write("\n");
+
+        last_status = 128 + SIGINT;
+    }
+}
+
+/**
+ * @brief Esta función copia stdin en stdout y en los archivos
+ *        indicados, como 'tee'.
+ *
+ * @details Sintaxis: tee [-a] [ARCHIVO...]
+ *          Con '-a' se agrega al final de los archivos en lugar de
+ *          sobrescribirlos.
+ *          Si stdin es un pipe, los datos no pasan por la shell: en
+ *          cada vuelta se duplica el contenido del pipe de entrada en
+ *          un pipe propio de cada salida con 'tee' (que no consume la
+ *          entrada), salvo en la última, a la que se mueve con 'splice'
+ *          (que sí la consume), y luego se vacía cada pipe propio en
+ *          su destino con tee_drain. Todas las salidas reciben los
+ *          mismos bytes en cada vuelta, y como la siguiente vuelta
+ *          empieza recién cuando se vaciaron todas, el ritmo lo marca
+ *          la salida más lenta. Los pipes propios tienen la capacidad
+ *          del pipe de entrada (o todos la menor que se haya podido
+ *          aplicar), y cada vuelta duplica como máximo esa capacidad,
+ *          por lo que cada duplicación entra completa en ellos.
+ *          Si no se puede escribir en alguna salida, se la descarta y
+ *          se continúa con el resto, con código de salida 1.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_tee(char **args)
+{
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    int first = 1;
+
+    if (args[1] && (strcmp(args[1], "-a") == 0))
+    {
+        flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC;
+        first = 2;
+    }
+
+    int amount = 1;
+
+    while (args[first + amount - 1])
+        amount++;
+
+    tee_out *outs = (tee_out *)arena_calloc(&cmd_arena, amount, sizeof(tee_out));
+    char **names = (char **)arena_alloc(&cmd_arena, amount * sizeof(char *));
+
+    char *buffer = NULL;
+
+    outs[0].fd = STDOUT_FILENO;
+    names[0] = "stdout";
+
+    for (int i = 1; i < amount; i++)
+    {
+        names[i] = args[first + i - 1];
+
+        if ((outs[i].fd = open(names[i], flags, 0666)) == -1)
+        {
+            char msg[_STR_MAX_LEN_];
+
+            snprintf(msg, sizeof(msg), "Could not open file %s: %s", names[i], strerror(errno));
+
+            show_err(msg, _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+        }
+    }
+
+    out_flush();
+
+    int pipe_len = fcntl(STDIN_FILENO, F_GETPIPE_SZ);
+
+    if (pipe_len == -1)
+        tee_copy(outs, names, amount, &buffer);
+
+    int chunk = pipe_len; // Capacidad de los pipes propios
+
+    for (int i = 0; (i < amount) && (pipe_len != -1); i++)
+    {
+        if (pipe2(outs[i].pipe, O_CLOEXEC) == -1)
+            show_err("Failed to create pipe", _FATAL_ERR_);
+
+        int size = fcntl(outs[i].pipe[1], F_SETPIPE_SZ, pipe_len);
+
+        if (size == -1)
+            size = fcntl(outs[i].pipe[1], F_GETPIPE_SZ);
+
+        if ((size > 0) && (size < chunk))
+            chunk = size;
+    }
+
+    /*
+        Si algún pipe propio no pudo agrandarse (por pipe-max-size o por
+        el límite de memoria en pipes del usuario), todos se achican a
+        su capacidad, para que cada duplicación entre completa en ellos.
+    */
+    for (int i = 0; (i < amount) && (pipe_len != -1) && (chunk < pipe_len); i++)
+        fcntl(outs[i].pipe[1], F_SETPIPE_SZ, chunk);
+
+    while (pipe_len != -1)
+    {
+        int last = amount - 1;
+
+        while ((last >= 0) && (outs[last].fd == -1))
+            last--;
+
+        if (last < 0)
+            break;
+
+        ssize_t len = -1; // Bytes de esta vuelta, según la primera duplicación
+
+        for (int i = 0; (i <= last) && (len != 0); i++)
+        {
+            if (outs[i].fd == -1)
+                continue;
+
+            // A la última salida se le mueve la entrada, consumiéndola
+            ssize_t moved = tee_take(outs[i].pipe[1], (len == -1) ? (size_t)chunk : (size_t)len, i == last, len != -1);
+
+            if ((moved == -1) || ((len != -1) && (moved != len)))
+            {
+                show_err((moved == -1) ? strerror(errno) : "Could not duplicate input", _NORM_ERR_);
+
+                last_status = EXIT_FAILURE;
+
+                pipe_len = -1;
+
+                break;
+            }
+
+            len = moved;
+        }
+
+        if ((len <= 0) || (pipe_len == -1))
+            break;
+
+        for (int i = 0; i <= last; i++)
+            if ((outs[i].fd != -1) && !tee_drain(&outs[i], len, &buffer))
+                tee_fail(&outs[i], errno, names[i]);
+    }
+
+    for (int i = 0; i < amount; i++)
+    {
+        if (outs[i].pipe[0] > 0)
+        {
+            close(outs[i].pipe[0]);
+            close(outs[i].pipe[1]);
+        }
+
+        if ((i > 0) && (outs[i].fd != -1))
+            close(outs[i].fd);
+    }
+
+    free(buffer);
+}
+
+/**
+ * @brief Esta función evalúa una expresión condicional ('test' o '[').
+ *
+ * @details Se soportan los operadores unarios -n, -z, -e, -f, -d, -r,
+ *          -w, -x, -s, -L, -h, -b, -c, -p, -S y -t, los binarios =, ==,
+ *          !=, <, >, -eq, -ne, -lt, -le, -gt, -ge, -nt, -ot y -ef, la
+ *          negación '!', los paréntesis y las conjunciones -a y -o.
+ *          El código de salida es 0 si la expresión es verdadera, 1 si
+ *          es falsa y 2 si tiene errores.
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_test(char **args)
+{
+    int amount = 0;
+
+    while (args[amount + 1])
+        amount++;
+
+    if (strcmp(args[0], "[") == 0)
+    {
+        if ((amount == 0) || (strcmp(args[amount], "]") != 0))
+        {
+            show_err("[: missing ']'", _NORM_ERR_);
+
+            last_status = 2;
+
+            return;
+        }
+
+        amount--;
+    }
+
+    test_args = &args[1];
+    test_amount = amount;
+    test_pos = 0;
+    test_failed = false;
+
+    bool result = (amount > 0) && test_or();
+
+    if (!test_failed && (test_pos < test_amount))
+    {
+        show_err("test: too many arguments", _NORM_ERR_);
+
+        test_failed = true;
+    }
+
+    last_status = test_failed ? 2 : !result;
+}
+
+/**
+ * @brief Esta función elimina variables de la shell o de entorno.
+ *
+ * @details Sintaxis: unset [-v] NOMBRE...
+ *
+ * @param args Argumentos del comando.
+ */
+void cmd_unset(char **args)
+{
+    for (int i = 1 + (args[1] && (strcmp(args[1], "-v") == 0)); args[i]; i++)
+    {
+        if (!is_var_name(args[i], strlen(args[i])))
+        {
+            show_err("unset: invalid variable name", _NORM_ERR_);
+
+            last_status = EXIT_FAILURE;
+
+            continue;
+        }
+
+        var_unset(args[i]);
+    }
+}
@@ -8,35 +8,193 @@
 
 #include "../headers/utilities.h"
 
+// Buffer de salida de los comandos internos (ver out_write)
+static char out_data[_OUT_BUF_LEN_];
+
+static size_t out_used = 0;
+
+static bool out_line = false; // Si se vacía en cada salto de línea (stdout es una terminal)
+
 /**
- * @brief Esta función restaura el stream original del proceso.
- *        Debe ser utilizada luego de una llamada a la función
- *        redirect_stdx.
+ * @brief Esta función escribe en stdout todos los fragmentos
+ *        indicados con la menor cantidad de llamadas posible.
  *
- * @param stdx Qué stream se desea restaurar.
+ * @details Se utiliza 'writev', que escribe varios fragmentos con
+ *          una sola llamada, y se continúa si la escritura fue
+ *          parcial. Si el lector de un pipe ya terminó (un comando
+ *          interno dentro de un pipe, con SIGPIPE ignorada), se
+ *          descarta el resto. Si no se logra, se aborta el programa.
+ *
+ * @param iov Fragmentos a escribir (se modifican).
+ * @param iov_amount Cantidad de fragmentos.
  */
-void restore_stdx(int stdx)
+static void out_writev(struct iovec *iov, int iov_amount)
 {
-    if (stdx == STDIN_FILENO)
+    while (iov_amount > 0)
     {
-        if (dup2(original_stdin, STDIN_FILENO) == -1)
-            show_err("Could not restore original STDIN stream", _FATAL_ERR_);
+        ssize_t written = writev(STDOUT_FILENO, iov, iov_amount);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if (errno == EPIPE)
+                return;
+
+            fprintf(stderr, "\nFatal error on write inscruction --- ABORTING\n");
+
+            exit(EXIT_FAILURE);
+        }
+
+        out_bytes += written;
 
-        if (close(original_stdin) == -1)
-            show_err("Could not close file descriptor when restoring original STDIN stream", _FATAL_ERR_);
+        // Salteamos los fragmentos ya escritos por completo
+        while ((iov_amount > 0) && ((size_t)written >= iov->iov_len))
+        {
+            written -= iov->iov_len;
+
+            iov++;
+            iov_amount--;
+        }
 
-        redirect_stdin_flag = false;
+        if (iov_amount > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
     }
-    else
+}
+
+/**
+ * @brief Esta función vacía el buffer de salida de los comandos
+ *        internos.
+ *
+ * @details Debe llamarse antes de cualquier acción que dependa del
+ *          orden de la salida: crear procesos, redirigir stdout,
+ *          escribir en stderr, mostrar el prompt o terminar.
+ */
+void out_flush(void)
+{
+    if (out_used == 0)
+        return;
+
+    struct iovec iov = { out_data, out_used };
+
+    out_used = 0;
+
+    out_writev(&iov, 1);
+}
+
+/**
+ * @brief Esta función agrega un mensaje al buffer de salida
+ *        de los comandos internos.
+ *
+ * @details Los mensajes se acumulan y se escriben en stdout todos
+ *          juntos cuando se llena el buffer, en lugar de hacer una
+ *          llamada a 'write' por cada uno. Si un mensaje no entra, se
+ *          lo escribe junto con lo acumulado en una sola llamada a
+ *          'writev', sin copiarlo. Si stdout es una terminal, el
+ *          buffer se vacía además en cada salto de línea, para que
+ *          el usuario vea cada línea apenas se completa.
+ *
+ * @param msg Mensaje a mostrar (puede contener '\0').
+ * @param len Largo del mensaje.
+ */
+void out_nwrite(char *msg, size_t len)
+{
+    // Al empezar a llenar el buffer, vemos hacia dónde apunta stdout
+    if (out_used == 0)
+        out_line = isatty(STDOUT_FILENO);
+
+    if (out_used + len > sizeof(out_data))
+    {
+        struct iovec iov[2] = { { out_data, out_used }, { msg, len } };
+
+        out_used = 0;
+
+        out_writev(iov, 2);
+
+        return;
+    }
+
+    memcpy(out_data + out_used, msg, len);
+
+    out_used += len;
+
+    if (out_line && memchr(msg, '\n', len))
+        out_flush();
+}
+
+/**
+ * @brief Esta función escribe un mensaje extenso en stdout sin
+ *        copiarlo, si stdout es un pipe.
+ *
+ * @details Con 'vmsplice' el pipe pasa a referenciar las páginas del
+ *          mensaje en lugar de copiarlas, por lo que el mensaje no
+ *          puede modificarse hasta que el lector las consuma. Por eso
+ *          los últimos bytes, tantos como la capacidad del pipe, se
+ *          escriben copiándolos: cuando esa escritura termina, el
+ *          lector ya consumió todas las páginas referenciadas y el
+ *          mensaje puede liberarse. Si stdout no es un pipe, si el
+ *          mensaje es corto o si out_splice no está activo, se
+ *          utiliza out_nwrite.
+ *
+ * @param msg Mensaje a mostrar (puede contener '\0').
+ * @param len Largo del mensaje.
+ */
+void out_nsplice(char *msg, size_t len)
+{
+    int pipe_len = ((len >= _SPLICE_MIN_LEN_) && out_splice) ? fcntl(STDOUT_FILENO, F_GETPIPE_SZ) : -1;
+
+    if ((pipe_len == -1) || (len <= (size_t)pipe_len))
+    {
+        out_nwrite(msg, len);
+
+        return;
+    }
+
+    out_flush();
+
+    struct iovec iov = { msg, len - pipe_len };
+
+    while (iov.iov_len > 0)
     {
-        if (dup2(original_stdout, STDOUT_FILENO) == -1)
-            show_err("Could not restore original STDOUT stream", _FATAL_ERR_);
+        ssize_t moved = vmsplice(STDOUT_FILENO, &iov, 1, 0);
+
+        if (moved == -1)
+        {
+            if (errno == EINTR)
+                continue;
 
-        if (close(original_stdout) == -1)
-            show_err("Could not close file descriptor when restoring original STDOUT stream", _FATAL_ERR_);
+            // El lector terminó: las páginas se liberan al cerrar el pipe
+            if (errno == EPIPE)
+                return;
 
-        redirect_stdout_flag = false;
+            // Si stdout no lo admite, se copia el resto
+            break;
+        }
+
+        out_bytes += moved;
+
+        iov.iov_base = (char *)iov.iov_base + moved;
+        iov.iov_len -= moved;
     }
+
+    iov.iov_len += pipe_len;
+
+    out_writev(&iov, 1);
+}
+
+/**
+ * @brief Esta función agrega un string al buffer de salida de los
+ *        comandos internos (ver out_nwrite).
+ *
+ * @param msg Mensaje a mostrar.
+ */
+void out_write(char *msg)
+{
+    out_nwrite(msg, strlen(msg));
 }
 
 /**
@@ -48,7 +206,13 @@ void restore_stdx(int stdx)
  */
 void show_err(char *msg, int err_type)
 {
-    try_write(STDERR_FILENO, mk_err_msg(msg, err_type));
+    char *err_msg = mk_err_msg(msg, err_type);
+
+    out_flush();
+
+    try_write(STDERR_FILENO, err_msg);
+
+    free(err_msg);
 
     if (err_type == _FATAL_ERR_)
         exit(EXIT_FAILURE);
@@ -124,7 +288,7 @@ char *mk_err_msg(char *msg, int err_type)
     if (err_type == _FATAL_ERR_)
     {
         // + 8 por "\nERROR ", + 7 por "[FATAL]", + 3 por " > " y + 4 por "\n\n"
-        err_msg = (char *)calloc(strlen(_FORMAT_BOLD_) + strlen(_FG_COLOR_WHITE_) + (strlen(_FORMAT_RESET_ALL_) * 2) +
+        err_msg = (char *)calloc(strlen(_FORMAT_BOLD_) + strlen(_FG_COLOR_WHITE_) + strlen(_BG_COLOR_LGRAY_) + (strlen(_FORMAT_RESET_ALL_) * 2) +
                                  strlen(msg) + sizeof(NULL) + (sizeof(char) * 22), sizeof(char));
 
         if (!err_msg)
@@ -233,82 +397,117 @@ bool open_file_r(FILE **file, char *dir)
 }
 
 /**
- * @brief Esta función se encarga de redirigir un stream del
- *        proceso a un file descriptor especificado mediante
- *        su nombre. Esta función es útil para redirigir un
- *        stream hacia algún archivo, no para operaciones
- *        con pipe.
+ * @brief Esta función copia todo el contenido de un file
+ *        descriptor en otro, sin pasar por memoria de usuario.
  *
- * @details Se abre un fd para el nuevo stream y se lo duplica
- *          al fd del stream correspondiente del proceso, y
- *          se cierra el fd abierto en primera instancia,
- *          almacenando una copia del mismo para una posterior
- *          restauración.
- *          Las flags utilizadas para abrir el nuevo stream de
- *          stdout indican que se abrirá el archivo en modo de
- *          sólo lectura y se creará si no existe. El nuevo
- *          stream de stdin se abrirá en modo de sólo lectura.
+ * @details Se intenta, en orden, con 'copy_file_range' (archivo a
+ *          archivo, que incluso puede compartir bloques en el disco),
+ *          'sendfile' (desde un archivo hacia cualquier destino) y
+ *          'splice' (cuando alguno de los extremos es un pipe). Cada
+ *          llamada mueve hasta _STREAM_CHUNK_LEN_ bytes dentro del
+ *          kernel. Si los file descriptors no admiten un mecanismo,
+ *          se pasa al siguiente y, como último recurso, se copia con
+ *          'read' y 'write' mediante un buffer de _STREAM_BUF_LEN_
+ *          bytes. Como todos los mecanismos avanzan los offsets de
+ *          los file descriptors, el cambio puede hacerse en cualquier
+ *          momento de la copia.
  *
- * @param new_stdx_name Nombre del file descriptor al cual
- *                      se va a redirigir el stream deseado.
- * @param stdx Qué stream se desea redirigir.
+ * @param in_fd File descriptor desde el que se copia hasta el EOF.
+ * @param out_fd File descriptor en el que se escribe.
  *
- * @returns Si se ha podido redirigir correctamente el stream.
+ * @returns Si se pudo copiar todo el contenido. En caso de falla,
+ *          errno indica el motivo.
  */
-bool redirect_stdx(char *new_stdx_name, int stdx)
+bool stream_fd(int in_fd, int out_fd)
 {
-    switch (stdx)
+    int method = 0; // 0: copy_file_range, 1: sendfile, 2: splice, 3: read/write
+
+    char *buffer = NULL;
+
+    while (true)
     {
-        case STDIN_FILENO:
+        ssize_t bytes;
+
+        switch (method)
         {
-            new_stdin = open(new_stdx_name, O_RDONLY, 0666);
+            case 0:
+            {
+                bytes = copy_file_range(in_fd, NULL, out_fd, NULL, _STREAM_CHUNK_LEN_, 0);
+
+                break;
+            }
 
-            if (new_stdin == -1)
+            case 1:
             {
-                show_err("Could not redirect STDIN", _NORM_ERR_);
+                bytes = sendfile(out_fd, in_fd, NULL, _STREAM_CHUNK_LEN_);
 
-                return false;
+                break;
             }
 
-            original_stdin = dup(STDIN_FILENO);
+            case 2:
+            {
+                bytes = splice(in_fd, NULL, out_fd, NULL, _STREAM_CHUNK_LEN_, SPLICE_F_MOVE);
 
-            if (original_stdin == -1)
-                show_err("Could not save original STDIN file descriptor", _FATAL_ERR_);
+                break;
+            }
 
-            if (dup2(new_stdin, STDIN_FILENO) == -1)
-                show_err("Could not duplicate STDIN", _FATAL_ERR_);
+            default:
+            {
+                if (!buffer && !(buffer = (char *)malloc(_STREAM_BUF_LEN_)))
+                    show_err("Could not allocate memory for stream buffer", _FATAL_ERR_);
 
-            if (close(new_stdin) == -1)
-                show_err("Could not close file descriptor when redirecting STDIN", _FATAL_ERR_);
+                bytes = read(in_fd, buffer, _STREAM_BUF_LEN_);
 
-            return true;
+                for (ssize_t written = 0, aux; (bytes > 0) && (written < bytes); written += aux)
+                    if ((aux = write(out_fd, buffer + written, bytes - written)) == -1)
+                    {
+                        if (errno != EINTR)
+                        {
+                            free(buffer);
+
+                            return false;
+                        }
+
+                        aux = 0;
+                    }
+
+                break;
+            }
         }
 
-        default:
+        if (bytes == 0)
+            break;
+
+        if (bytes > 0)
+            out_bytes += bytes;
+
+        if (bytes == -1)
         {
-            new_stdout = open(new_stdx_name, (O_WRONLY | O_CREAT), 0666);
+            if (errno == EINTR)
+                continue;
 
-            if (new_stdout == -1)
+            // El mecanismo no es compatible con estos file descriptors: probamos con el siguiente
+            if ((method < 3) && ((errno == EINVAL) || (errno == ENOSYS) || (errno == EXDEV) ||
+                                 (errno == EOPNOTSUPP) || (errno == EBADF)))
             {
-                show_err("Could not redirect STDOUT", _NORM_ERR_);
+                method++;
 
-                return false;
+                continue;
             }
 
-            original_stdout = dup(STDOUT_FILENO);
+            int err = errno;
 
-            if (original_stdout == -1)
-                show_err("Could not save original STDOUT file descriptor", _FATAL_ERR_);
+            free(buffer);
 
-            if (dup2(new_stdout, STDOUT_FILENO) == -1)
-                show_err("Could not duplicate STDOUT", _FATAL_ERR_);
+            errno = err;
 
-            if (close(new_stdout) == -1)
-                show_err("Could not close file descriptor when redirecting STDOUT", _FATAL_ERR_);
-
-            return true;
+            return false;
         }
     }
+
+    free(buffer);
+
+    return true;
 }
 
 /**
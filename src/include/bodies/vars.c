@@ -0,0 +1,214 @@
+/**
+ * @file vars.c
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Librería con la tabla de variables de la shell.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#include "../headers/vars.h"
+
+/**
+ * @brief Esta función calcula el hash FNV-1a de un string.
+ *
+ * @param str String a hashear.
+ *
+ * @returns El hash del string.
+ */
+static unsigned long var_hash(char *str)
+{
+    unsigned long hash = 14695981039346656037UL;
+
+    while (*str)
+    {
+        hash ^= (unsigned char)*str++;
+        hash *= 1099511628211UL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Esta función busca la posición de una variable en la tabla.
+ *
+ * @details Se utiliza direccionamiento abierto con sondeo lineal,
+ *          por lo que se devuelve la posición donde está la variable
+ *          o la primera posición libre donde debería insertarse.
+ *
+ * @param table Tabla en la que se busca.
+ * @param size Tamaño de la tabla (potencia de 2).
+ * @param name Nombre de la variable.
+ *
+ * @returns La entrada correspondiente a la variable.
+ */
+static var_entry *var_slot(var_entry *table, size_t size, char *name)
+{
+    size_t i = var_hash(name) & (size - 1);
+
+    while (table[i].name && (strcmp(table[i].name, name) != 0))
+        i = (i + 1) & (size - 1);
+
+    return &table[i];
+}
+
+/**
+ * @brief Esta función duplica el tamaño de la tabla, reubicando
+ *        las variables existentes.
+ */
+static void vars_grow(void)
+{
+    size_t new_size = vars_size ? (vars_size * 2) : _VARS_INIT_SIZE_;
+
+    var_entry *new_table = (var_entry *)calloc(new_size, sizeof(var_entry));
+
+    if (!new_table)
+        show_err("Could not allocate memory for shell variables table", _FATAL_ERR_);
+
+    for (size_t i = 0; i < vars_size; i++)
+        if (vars_table[i].name)
+            *var_slot(new_table, new_size, vars_table[i].name) = vars_table[i];
+
+    free(vars_table);
+
+    vars_table = new_table;
+    vars_size = new_size;
+}
+
+/**
+ * @brief Esta función indica si un string es un nombre de variable
+ *        válido: letras, dígitos y '_', sin comenzar con un dígito.
+ *
+ * @param name String a analizar.
+ * @param len Largo del nombre.
+ *
+ * @returns Si el string es un nombre válido.
+ */
+bool is_var_name(char *name, size_t len)
+{
+    if ((len == 0) || ((name[0] >= '0') && (name[0] <= '9')))
+        return false;
+
+    for (size_t i = 0; i < len; i++)
+        if (!(((name[i] >= 'a') && (name[i] <= 'z')) || ((name[i] >= 'A') && (name[i] <= 'Z')) ||
+              ((name[i] >= '0') && (name[i] <= '9')) || (name[i] == '_')))
+            return false;
+
+    return true;
+}
+
+/**
+ * @brief Esta función obtiene el valor de una variable.
+ *
+ * @details Las variables de la shell tienen prioridad sobre las
+ *          variables de entorno.
+ *
+ * @param name Nombre de la variable.
+ *
+ * @returns El valor de la variable, o NULL si no existe.
+ */
+char *var_get(char *name)
+{
+    if (vars_used > 0)
+    {
+        var_entry *e = var_slot(vars_table, vars_size, name);
+
+        if (e->value)
+            return e->value;
+    }
+
+    return getenv(name);
+}
+
+/**
+ * @brief Esta función asigna un valor a una variable.
+ *
+ * @details Las variables de entorno se modifican en el entorno, por
+ *          lo que siguen siendo visibles para los programas que lance
+ *          la shell. El resto son variables de la shell, que sólo
+ *          existen dentro de su proceso y no se exportan.
+ *
+ * @param name Nombre de la variable.
+ * @param value Valor a asignar.
+ */
+void var_set(char *name, char *value)
+{
+    if (getenv(name))
+    {
+        if (setenv(name, value, 1) == -1)
+            show_err("Could not set environment variable", _NORM_ERR_);
+
+        return;
+    }
+
+    // Se mantiene la tabla a lo sumo a la mitad de su capacidad
+    if ((vars_used + 1) * 2 > vars_size)
+        vars_grow();
+
+    var_entry *e = var_slot(vars_table, vars_size, name);
+
+    char *copy = strdup(value);
+
+    if (!copy)
+        show_err("Could not allocate memory for shell variable", _FATAL_ERR_);
+
+    if (!e->name)
+    {
+        if (!(e->name = strdup(name)))
+            show_err("Could not allocate memory for shell variable", _FATAL_ERR_);
+
+        vars_used++;
+    }
+
+    free(e->value);
+
+    e->value = copy;
+}
+
+/**
+ * @brief Esta función elimina una variable de la shell o de entorno.
+ *
+ * @param name Nombre de la variable.
+ */
+void var_unset(char *name)
+{
+    if (vars_used > 0)
+    {
+        var_entry *e = var_slot(vars_table, vars_size, name);
+
+        // La entrada se conserva (sin valor) para no cortar las secuencias de sondeo
+        free(e->value);
+
+        e->value = NULL;
+    }
+
+    if (unsetenv(name) == -1)
+        show_err("Could not unset environment variable", _NORM_ERR_);
+}
+
+/**
+ * @brief Esta función exporta una variable, para que la vean los
+ *        programas que lance la shell.
+ *
+ * @details La variable pasa de la tabla de la shell al entorno. Si no
+ *          existe y no se indica un valor, no se hace nada.
+ *
+ * @param name Nombre de la variable.
+ * @param value Valor a asignar, o NULL para conservar el actual.
+ */
+void var_export(char *name, char *value)
+{
+    var_entry *e = (vars_used > 0) ? var_slot(vars_table, vars_size, name) : NULL;
+
+    if (!value && e && e->value)
+        value = e->value;
+
+    if (value && (setenv(name, value, 1) == -1))
+        show_err("Could not set environment variable", _NORM_ERR_);
+
+    if (e)
+    {
+        free(e->value);
+
+        e->value = NULL;
+    }
+}
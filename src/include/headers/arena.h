@@ -0,0 +1,53 @@
+/**
+ * @file arena.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con un asignador de memoria por
+ *        regiones (arena) para los datos de cada comando.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __ARENA__
+#define __ARENA__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "utilities.h"
+#include <stddef.h>
+
+/* ---------- Definición de constantes ---------- */
+
+#define _ARENA_BLOCK_LEN_ 16384
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct arena_block
+{
+    struct arena_block *next; // Bloque reservado anteriormente
+
+    size_t cap; // Capacidad de data
+    size_t used; // Bytes ya entregados
+
+    max_align_t data[]; // Memoria a repartir, alineada para cualquier tipo
+} arena_block;
+
+typedef struct arena
+{
+    arena_block *head; // Bloque actual, o NULL si aún no se reservó ninguno
+} arena;
+
+/* ---------- Declaración de variables ---------- */
+
+arena cmd_arena; // Arena de la línea que se está analizando y ejecutando
+
+/* ---------- Prototipado de funciones ---------- */
+
+void arena_free(arena *);
+void arena_reset(arena *);
+
+void *arena_alloc(arena *, size_t);
+void *arena_calloc(arena *, size_t, size_t);
+
+char *arena_strdup(arena *, char *);
+
+#endif
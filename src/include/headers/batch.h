@@ -0,0 +1,114 @@
+/**
+ * @file batch.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con la ejecución de las líneas de
+ *        los batchfiles, en serie o en paralelo.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __BATCH__
+#define __BATCH__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "control.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* ---------- Definición de constantes ---------- */
+
+#define _SHC_MAGIC_ 0x4348534d // "MSHC"
+#define _SHC_VERSION_ 6
+
+/* ---------- Definición de tipos --------------- */
+
+/*
+    Formato de los batchfiles compilados (.shc). Todas las referencias
+    son offsets desde el comienzo del archivo (0 equivale a NULL), de
+    modo que se lo puede usar directamente tal como queda mapeado.
+*/
+typedef struct shc_header
+{
+    uint32_t magic;
+    uint32_t version;
+
+    int64_t mtime_sec; // Fecha de modificación del batchfile compilado
+    int64_t mtime_nsec;
+    int64_t size; // Tamaño del batchfile compilado
+
+    uint32_t path_env; // $PATH con el que se resolvieron los programas
+    uint32_t lines; // Cantidad de líneas
+    uint32_t lines_off; // Arreglo con el offset de cada línea
+    uint32_t len; // Tamaño del archivo .shc
+} shc_header;
+
+typedef struct shc_line
+{
+    uint32_t text; // Línea original
+    uint32_t cmds; // Arreglo de etapas, o 0 si la línea se analiza al ejecutarla
+
+    int32_t cmds_amount;
+
+    uint8_t bg;
+    uint8_t timed;
+    uint8_t cpus_list;
+    uint8_t spread;
+
+    uint32_t pipe_size; // Palabra del prefijo 'pipesize', o 0
+    uint32_t cpus; // Palabra del prefijo 'taskset', o 0
+    uint32_t niceness; // Palabra del prefijo 'nice', o 0
+    uint32_t limits; // Palabra del prefijo 'limit', o 0
+} shc_line;
+
+typedef struct shc_cmd
+{
+    uint32_t argv; // Arreglo con el offset de cada palabra
+    int32_t argc;
+    int32_t builtin;
+
+    uint32_t redirs; // Arreglo de redirecciones, o 0
+    int32_t redirs_amount;
+
+    uint32_t path; // Path del programa ya resuelto, o 0
+} shc_cmd;
+
+typedef struct shc_redir
+{
+    int32_t fd;
+    int32_t flags;
+    int32_t dup_fd;
+
+    uint32_t file; // Archivo, o 0 si se duplica dup_fd
+} shc_redir;
+
+typedef struct shc_buf
+{
+    char *data;
+
+    size_t len;
+    size_t cap;
+
+    bool full; // Si se superó el máximo direccionable con offsets de 32 bits
+} shc_buf;
+
+typedef struct worker
+{
+    int id; // Número del trabajo en la tabla de trabajos
+
+    int out_fd; // Archivo en memoria con el stdout de la línea
+    int err_fd; // Archivo en memoria con el stderr de la línea
+} worker;
+
+/* ---------- Declaración de variables ---------- */
+
+int batch_width; // Líneas a ejecutar en paralelo con '-j', o 0 para ejecutarlas en serie
+
+/* ---------- Prototipado de funciones ---------- */
+
+void batch_end(void);
+
+bool batch_line(char *);
+bool batch_script(char *, int);
+
+#endif
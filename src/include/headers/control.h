@@ -0,0 +1,90 @@
+/**
+ * @file control.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con las estructuras de control
+ *        de la shell ('for', 'while' e 'if').
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __CONTROL__
+#define __CONTROL__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "shell_cmds.h"
+
+/* ---------- Definición de constantes ---------- */
+
+// PALABRAS CLAVE
+#define _KW_NONE_ -1
+#define _KW_FOR_ 0
+#define _KW_WHILE_ 1
+#define _KW_IF_ 2
+#define _KW_DO_ 3
+#define _KW_DONE_ 4
+#define _KW_THEN_ 5
+#define _KW_ELIF_ 6
+#define _KW_ELSE_ 7
+#define _KW_FI_ 8
+#define _KW_BREAK_ 9
+#define _KW_CONTINUE_ 10
+
+// TIPOS DE NODOS
+#define _NODE_CMD_ 0
+#define _NODE_FOR_ 1
+#define _NODE_WHILE_ 2
+#define _NODE_IF_ 3
+#define _NODE_BREAK_ 4
+#define _NODE_CONTINUE_ 5
+
+// SALTOS PENDIENTES
+#define _JUMP_NONE_ 0
+#define _JUMP_BREAK_ 1
+#define _JUMP_CONTINUE_ 2
+#define _JUMP_ABORT_ 3 // Un comando terminó por Ctrl+C
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct node
+{
+    int type;
+
+    char *text; // Línea original
+
+    pipeline *pl; // Comando, o condición de 'while' e 'if'
+
+    char *var; // Variable de 'for'
+    char **words; // Palabras de 'for', sin expandir y terminadas en NULL
+
+    struct node *body; // Cuerpo del bucle, o rama 'then' de 'if'
+    struct node *alt; // Rama 'else' (o 'elif') de 'if'
+    struct node *next; // Siguiente nodo del mismo bloque
+} node;
+
+typedef struct ctl_frame
+{
+    node *blk; // Estructura abierta
+
+    node **tail; // Donde se agrega el próximo nodo
+
+    bool opened; // Si ya se leyó su 'do' o 'then'
+    bool in_else; // Si se está en la rama 'else'
+    bool chained; // Si es un 'elif', que se cierra con el 'fi' de su 'if'
+} ctl_frame;
+
+/* ---------- Declaración de variables ---------- */
+
+arena ctl_arena; // Arena de la estructura de control que se está leyendo
+
+/* ---------- Prototipado de funciones ---------- */
+
+void ctl_end(void);
+
+bool ctl_exec(node *);
+bool ctl_line(char *);
+bool ctl_takes(char *);
+
+node *ctl_feed(char *, pipeline *);
+
+#endif
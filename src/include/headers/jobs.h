@@ -0,0 +1,90 @@
+/**
+ * @file jobs.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con la tabla de trabajos (jobs)
+ *        de la shell y el manejo de la señal SIGCHLD.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __JOBS__
+#define __JOBS__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "stats.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+
+/* ---------- Definición de constantes ---------- */
+
+#define _JOB_RUNNING_ 0
+#define _JOB_STOPPED_ 1
+#define _JOB_DONE_ 2
+
+#define _JOBS_KEEP_ 64 // Trabajos terminados que se conservan fuera del modo interactivo
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct proc
+{
+    pid_t pid;
+
+    int status; // Estado devuelto por 'wait4'
+
+    bool done;
+    bool stopped;
+
+    struct rusage usage; // Recursos consumidos por el proceso
+    struct timespec end; // Momento en el que terminó
+} proc;
+
+typedef struct job
+{
+    int id; // Número de trabajo (%n)
+    int state;
+    int alive; // Procesos que aún no terminaron
+
+    pid_t pgid; // Grupo de procesos, o 0 si comparte el de la shell
+
+    bool bg;
+
+    proc *procs; // Procesos del trabajo, uno por etapa
+    int procs_amount;
+
+    char *cmd; // Línea de comandos que originó el trabajo
+
+    struct timespec start;
+    struct timespec end;
+} job;
+
+/* ---------- Declaración de variables ---------- */
+
+job *jobs_table;
+
+int jobs_amount, jobs_cap;
+
+/* ---------- Prototipado de funciones ---------- */
+
+void jobs_block(void);
+void jobs_clear(void);
+void jobs_init(void);
+void jobs_notify(void);
+void jobs_prune(void);
+void jobs_show(void);
+void jobs_unblock(void);
+
+int job_add(pid_t *, int, pid_t, char *, bool);
+int job_code(job *);
+int job_wait(int, bool, proc *);
+int jobs_wait_any(void);
+int jobs_wait_fg(int *);
+int proc_code(proc *);
+
+double job_elapsed(job *);
+
+job *job_find(char *);
+job *job_get(int);
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file line_reader.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con un lector de líneas
+ *        con buffer para file descriptors.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __LINE_READER__
+#define __LINE_READER__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "utilities.h"
+
+/* ---------- Definición de constantes ---------- */
+
+#define _READ_BUF_LEN_ 65536 // Capacidad inicial del buffer
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct line_reader
+{
+    int fd; // File descriptor del que se leen las líneas
+
+    char *buf;
+
+    size_t cap; // Capacidad del buffer (sin contar el '\0' final)
+    size_t max; // Capacidad máxima a la que puede crecer el buffer
+    size_t start; // Comienzo de los datos aún no devueltos
+    size_t end; // Fin de los datos leídos
+
+    bool eof;
+    bool skip; // Si se está descartando el resto de una línea demasiado larga
+} line_reader;
+
+/* ---------- Prototipado de funciones ---------- */
+
+void reader_free(line_reader *);
+void reader_init(line_reader *, int);
+
+char *reader_next(line_reader *, size_t *);
+
+#endif
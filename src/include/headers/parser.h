@@ -0,0 +1,134 @@
+/**
+ * @file parser.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con el analizador léxico y
+ *        sintáctico de las líneas de comandos de la shell.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __PARSER__
+#define __PARSER__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "arena.h"
+#include "vars.h"
+
+/* ---------- Definición de constantes ---------- */
+
+// TIPOS DE TOKENS
+#define _TOK_WORD_ 0
+#define _TOK_PIPE_ 1
+#define _TOK_LT_ 2
+#define _TOK_GT_ 3
+#define _TOK_AMP_ 4
+#define _TOK_GTGT_ 5 // '>>'
+#define _TOK_DUP_ 6 // '>&' y '<&'
+
+#define _FD_MAX_DIGITS_ 4 // Dígitos del file descriptor antes de una redirección (N>)
+
+// COMANDOS INTERNOS
+#define _BI_EXPAND_ -1 // Se sabrá recién al expandir el nombre del comando
+#define _BI_NONE_ 0
+#define _BI_BG_ 1
+#define _BI_CD_ 2
+#define _BI_CLR_ 3
+#define _BI_ECHO_ 4
+#define _BI_FG_ 5
+#define _BI_HASH_ 6
+#define _BI_JOBS_ 7
+#define _BI_QUIT_ 8
+#define _BI_REHASH_ 9
+#define _BI_SET_ 10
+#define _BI_WAIT_ 11
+#define _BI_SHSTAT_ 12
+#define _BI_FORALL_ 13
+#define _BI_ASSIGN_ 14 // Asignación de una variable (NOMBRE=valor)
+#define _BI_TRUE_ 15
+#define _BI_FALSE_ 16
+#define _BI_PWD_ 17
+#define _BI_PRINTF_ 18
+#define _BI_TEST_ 19 // 'test' y '['
+#define _BI_SLEEP_ 20
+#define _BI_KILL_ 21
+#define _BI_EXPORT_ 22
+#define _BI_UNSET_ 23
+#define _BI_EXEC_ 24
+#define _BI_TEE_ 25
+
+#define _BI_TABLE_SIZE_ 64 // Tamaño de la tabla de hashing perfecta (potencia de 2)
+#define _BI_MAX_LEN_ 6 // Largo del nombre de comando interno más largo
+
+/*
+    Marca de un '$' que debe expandirse al ejecutar el comando.
+    Los '$' entre comillas simples o escapados quedan tal cual.
+*/
+#define _VAR_MARK_ '\x01'
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct token
+{
+    int type;
+
+    char *word; // Texto de la palabra (sólo para _TOK_WORD_)
+
+    int fd; // File descriptor a redirigir (sólo para las redirecciones)
+} token;
+
+typedef struct redir
+{
+    int fd; // File descriptor a redirigir
+    int flags; // Flags de 'open' para el archivo, o -1 si se duplica dup_fd
+    int dup_fd; // File descriptor a duplicar (N>&M), o -1
+
+    char *file; // Archivo, o NULL si se duplica dup_fd
+} redir;
+
+typedef struct command
+{
+    char **argv; // Palabras del comando terminadas en NULL, sin expandir
+    int argc;
+
+    int builtin; // Comando interno, o _BI_NONE_ si es un programa externo
+
+    redir *redirs; // Redirecciones, en el orden en que deben aplicarse
+    int redirs_amount;
+
+    char *path; // Path del programa ya resuelto (batchfiles compilados), o NULL
+} command;
+
+typedef struct pipeline
+{
+    command *cmds; // Etapas del comando, separadas por '|'
+    int cmds_amount;
+
+    bool bg; // Si la línea termina en '&'
+    bool timed; // Si la línea comienza con la palabra clave 'time'
+
+    char *pipe_size; // Capacidad de sus pipes (prefijo 'pipesize'), sin expandir, o NULL
+    char *cpus; // CPUs permitidas (prefijo 'taskset'), sin expandir, o NULL
+    char *niceness; // Ajuste de la prioridad (prefijo 'nice'), sin expandir, o NULL
+    char *limits; // Límites de recursos (prefijo 'limit'), sin expandir, o NULL
+
+    bool cpus_list; // Si cpus es una lista ('taskset -c') en lugar de una máscara
+    bool spread; // Si cada etapa se fija a una CPU distinta ('taskset -s')
+
+    char *text; // Línea original, para la tabla de trabajos
+} pipeline;
+
+/* ---------- Declaración de variables ---------- */
+
+int last_status; // Código de salida del último comando ejecutado ($?)
+
+/* ---------- Prototipado de funciones ---------- */
+
+int builtin_id(char *);
+int lex_line(char *, token *, char *);
+
+char *expand_word(arena *, char *);
+
+pipeline *parse_line(arena *, char *, char **);
+
+#endif
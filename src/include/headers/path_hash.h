@@ -0,0 +1,48 @@
+/**
+ * @file path_hash.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con la tabla de hashing que
+ *        almacena la ubicación de los programas estándar
+ *        encontrados en los directorios de $PATH.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __PATH_HASH__
+#define __PATH_HASH__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "utilities.h"
+#include <sys/stat.h>
+
+/* ---------- Definición de constantes ---------- */
+
+#define _HASH_INIT_SIZE_ 64 // Debe ser una potencia de 2
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct hash_entry
+{
+    char *name; // Nombre del programa tal y como lo ingresó el usuario
+    char *path; // Path absoluto resuelto mediante $PATH
+
+    unsigned long hits; // Cantidad de veces que se utilizó la entrada
+} hash_entry;
+
+/* ---------- Declaración de variables ---------- */
+
+hash_entry *hash_table;
+
+size_t hash_size, hash_used;
+
+char *hash_path; // Copia de $PATH con la que se llenó la tabla
+
+/* ---------- Prototipado de funciones ---------- */
+
+void hash_reset(void);
+void hash_show(void);
+
+char *hash_lookup(char *);
+
+#endif
@@ -13,17 +13,83 @@
 
 /* ---------- Librerías a utilizar -------------- */
 
+#include "jobs.h"
+#include "line_reader.h"
 #include "shell_utilities.h"
+#include "timing.h"
+#include "util_cmds.h"
+#include <sched.h>
+#include <spawn.h>
 #include <sys/prctl.h>
 #include <sys/wait.h>
 
+/* ---------- Definición de constantes ---------- */
+
+#define _LAUNCH_FORK_ 0
+#define _LAUNCH_SPAWN_ 1
+
+#define _FD_SAVE_MIN_ 10 // Mínimo para las copias de los file descriptors redirigidos en la shell
+
+#define _RLIMITS_MAX_ 8 // Recursos distintos que pueden limitarse con el prefijo 'limit'
+
+#define _PIPE_MAX_SIZE_PATH_ "/proc/sys/fs/pipe-max-size" // Capacidad máxima de un pipe sin privilegios
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct stage
+{
+    char **args; // Argumentos ya expandidos
+
+    char *path; // Path del programa, o NULL si es un comando interno
+
+    redir *redirs; // Redirecciones, con sus archivos ya expandidos
+    int redirs_amount;
+
+    int builtin;
+} stage;
+
+// Configuración que se aplica a los procesos de una línea antes de 'execv'
+typedef struct launch_setup
+{
+    cpu_set_t cpus; // CPUs en las que pueden ejecutarse (prefijo 'taskset')
+    int cpus_amount; // Cantidad de CPUs de cpus, o 0 si no se restringen
+
+    bool spread; // Si cada etapa se fija a una sola CPU de cpus ('taskset -s')
+
+    int niceness; // Prioridad de los procesos (prefijo 'nice')
+    bool set_niceness;
+
+    int resources[_RLIMITS_MAX_]; // Recursos a limitar (prefijo 'limit')
+    struct rlimit limits[_RLIMITS_MAX_];
+    int limits_amount;
+} launch_setup;
+
+/* ---------- Declaración de variables ---------- */
+
+int launch_mode; // Mecanismo para lanzar programas externos
+int pipe_size; // Capacidad de los pipes que crea la shell, o 0 para la del sistema
+
 /* ---------- Prototipado de funciones ---------- */
 
-void cmd_cd(char *);
+void child_setup(pid_t, pid_t);
+void cmd_assign(char **);
+void cmd_cd(char **);
 void cmd_clr(void);
-void cmd_exec(void);
+void cmd_echo(char **, bool);
+void cmd_exec(pipeline *, stage *);
+void cmd_forall(char **);
+void cmd_hash(char **);
+void cmd_jobs(char **);
+void cmd_set(char **);
+void cmd_shstat(char **);
+void run_job(pipeline *, pid_t *, int, pid_t, proc *);
+
+int pipe_size_parse(char *);
+
+pid_t launch_prog(char *, char **, int, int, redir *, int, pid_t, launch_setup *);
 
-bool cmd_echo(char *, bool);
+bool exec_line(pipeline *);
 bool read_line(char *);
+bool run_line(pipeline *, uint64_t);
 
 #endif
\ No newline at end of file
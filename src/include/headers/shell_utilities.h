@@ -12,9 +12,8 @@
 
 /* ---------- Librerías a utilizar -------------- */
 
-#include "utilities.h"
-#include <malloc.h>
-#include <regex.h>
+#include "parser.h"
+#include "path_hash.h"
 
 /* ---------- Definición de constantes ---------- */
 
@@ -22,38 +21,22 @@
 #define _WELC_ -2
 #define _FARE_ -1
 #define _EXPS_ 0
-#define _STD_ 1
-#define _ABS_ 2
-#define _REL_ 3
 
 /* ---------- Declaración de variables ---------- */
 
-int args_amount, prog_type;
-
-char input[_STR_MAX_LEN_];
-char aux_input[_STR_MAX_LEN_];
-
 char *base_cwd; // CWD base de la ubicación del proyecto - para redirecciones
-char *pipe_cmd;
-char *prog_name;
-char *prog_path; // Directorio actual de búsqueda
-
-char **prog_args;
+char *shell_cwd; // Directorio actual de trabajo, actualizado sólo por cwd_update
+char *prompt; // Prompt ya armado, listo para mostrar
 
-bool pipe_flag, bg_flag, cd_flag,
-     clr_flag, echo_flag, quit_flag;
+size_t prompt_len;
 
-regex_t bg_regex, cd_regex, clr_regex,
-        echo_regex, pipe_regex, quit_regex;
+bool prompt_stale; // Si el prompt debe volver a armarse
 
 /* ---------- Prototipado de funciones ---------- */
 
-void mk_prompt(char *, char *, char **);
+void cwd_update(void);
+void mk_prompt(char *, char *);
 void print_hmsg(int);
 void show_help(int);
 
-int set_flags(char *);
-
-bool get_prog_data(char *);
-
 #endif
\ No newline at end of file
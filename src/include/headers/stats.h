@@ -0,0 +1,79 @@
+/**
+ * @file stats.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con los contadores y las mediciones
+ *        de latencia internas de la shell (comando 'shstat').
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __STATS__
+#define __STATS__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "utilities.h"
+#include <inttypes.h>
+#include <time.h>
+
+/* ---------- Definición de constantes ---------- */
+
+// FASES MEDIDAS
+#define _PH_READ_ 0 // Lectura de una línea (sólo fuera del modo interactivo)
+#define _PH_PARSE_ 1 // Análisis léxico y sintáctico
+#define _PH_PREPARE_ 2 // Expansión y búsqueda de los programas
+#define _PH_REDIR_ 3 // Redirecciones de los comandos internos
+#define _PH_LAUNCH_ 4 // Creación de cada proceso (fork o spawn)
+#define _PH_WAIT_ 5 // Espera de los trabajos en foreground
+#define _PH_OVERHEAD_ 6 // Tiempo de cada línea sin contar la espera
+#define _PHASES_AMOUNT_ 7
+
+/*
+    Cada potencia de 2 de nanosegundos se divide en 2^_HIST_SUB_BITS_
+    intervalos iguales, por lo que los percentiles tienen un error
+    relativo menor al 12,5% sin importar la escala.
+*/
+#define _HIST_SUB_BITS_ 3
+#define _HIST_BUCKETS_ (64 << _HIST_SUB_BITS_)
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct phase_stat
+{
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+
+    uint64_t hist[_HIST_BUCKETS_]; // Histograma de latencias
+} phase_stat;
+
+typedef struct shell_stats
+{
+    uint64_t commands; // Líneas ejecutadas
+    uint64_t builtins; // Comandos internos ejecutados en la shell
+    uint64_t spawns; // Procesos lanzados con 'posix_spawn'
+    uint64_t forks; // Procesos lanzados con 'fork'
+    uint64_t failed_execs; // Programas que no se encontraron o no se pudieron lanzar
+    uint64_t parse_errors;
+    uint64_t pipes; // Pipes creados para conectar etapas
+    uint64_t pipe_resize_errors; // Pipes a los que no se les pudo aplicar la capacidad elegida
+    uint64_t pipe_size; // Capacidad del último pipe creado
+
+    uint64_t line_wait_ns; // Espera acumulada de la línea en curso
+
+    phase_stat phases[_PHASES_AMOUNT_];
+} shell_stats;
+
+/* ---------- Declaración de variables ---------- */
+
+shell_stats sh_stats;
+
+/* ---------- Prototipado de funciones ---------- */
+
+void stats_reset(void);
+void stats_show(bool);
+
+uint64_t stat_now(void);
+uint64_t stat_phase(int, uint64_t);
+
+#endif
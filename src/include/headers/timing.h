@@ -0,0 +1,53 @@
+/**
+ * @file timing.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con la medición de los recursos
+ *        consumidos por los comandos (palabra clave 'time').
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __TIMING__
+#define __TIMING__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "utilities.h"
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <time.h>
+
+/* ---------- Definición de constantes ---------- */
+
+// FORMATOS DEL REPORTE DE 'time'
+#define _TIME_HUMAN_ 0 // Tabla con una fila por etapa y el total
+#define _TIME_POSIX_ 1 // Sólo real, user y sys del total, como 'time -p'
+#define _TIME_JSON_ 2 // Un objeto JSON por comando, en una línea
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct stage_time
+{
+    char *name; // Nombre de la etapa (su argv[0])
+
+    pid_t pid;
+
+    int status; // Código de salida de la etapa
+
+    double real; // Segundos desde que comenzó el comando hasta que terminó la etapa
+
+    struct rusage usage; // Recursos consumidos por la etapa
+} stage_time;
+
+/* ---------- Declaración de variables ---------- */
+
+int time_format; // Formato del reporte de 'time'
+
+/* ---------- Prototipado de funciones ---------- */
+
+void time_report(char *, stage_time *, int, double);
+
+double ts_diff(struct timespec *, struct timespec *);
+double tv_secs(struct timeval *);
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file util_cmds.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con los comandos internos de
+ *        utilidades, que se ejecutan sin crear procesos.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __UTIL_CMDS__
+#define __UTIL_CMDS__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "jobs.h"
+#include "shell_utilities.h"
+
+/* ---------- Definición de tipos --------------- */
+
+// Salida de 'tee'
+typedef struct tee_out
+{
+    int fd; // Destino, o -1 si ya no se puede escribir en él
+    int pipe[2]; // Pipe propio en el que se duplica la entrada antes de moverla al destino
+
+    bool copy; // Si el destino no admite 'splice' y debe copiarse
+} tee_out;
+
+/* ---------- Prototipado de funciones ---------- */
+
+void cmd_export(char **);
+void cmd_kill(char **);
+void cmd_printf(char **);
+void cmd_pwd(void);
+void cmd_replace(char **);
+void cmd_sleep(char **);
+void cmd_tee(char **);
+void cmd_test(char **);
+void cmd_unset(char **);
+
+#endif
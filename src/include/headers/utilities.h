@@ -11,13 +11,18 @@
 
 /* ---------- Librerías a utilizar -------------- */
 
+#define _GNU_SOURCE // Funciones de glibc específicas de Linux
+
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 /* ---------- Definición de constantes ---------- */
@@ -47,18 +52,24 @@
 #define _NORM_ERR_ 0
 #define _FATAL_ERR_ 1
 
-/* ---------- Declaración de variables ---------- */
+#define _OUT_BUF_LEN_ 8192 // Buffer de salida de los comandos internos
 
-int original_stdin, original_stdout, new_stdin, new_stdout;
+#define _STREAM_CHUNK_LEN_ (1 << 30) // Máximo a mover por llamada dentro del kernel
+#define _STREAM_BUF_LEN_ (1 << 20) // Buffer para copiar cuando no se puede en el kernel
+#define _SPLICE_MIN_LEN_ (1 << 18) // Mensajes a partir de los cuales conviene 'vmsplice'
+
+/* ---------- Declaración de variables ---------- */
 
-char new_stdin_name[_STR_MAX_LEN_];
-char new_stdout_name[_STR_MAX_LEN_];
+unsigned long long out_bytes; // Bytes escritos por los comandos internos
 
-bool redirect_stdin_flag, redirect_stdout_flag;
+bool out_splice; // Si out_nsplice puede pasar mensajes a un pipe sin copiarlos
 
 /* ---------- Prototipado de funciones ---------- */
 
-void restore_stdx(int);
+void out_flush(void);
+void out_nsplice(char *, size_t);
+void out_nwrite(char *, size_t);
+void out_write(char *);
 void show_err(char *, int);
 void try_kill(int, int);
 void try_write(int, char *);
@@ -68,7 +79,7 @@ char *mk_err_msg(char *, int);
 char *strtrim(char *);
 
 bool open_file_r(FILE **, char *);
-bool redirect_stdx(char *, int);
+bool stream_fd(int, int);
 bool stremp(char *);
 
 #endif
\ No newline at end of file
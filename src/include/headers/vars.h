@@ -0,0 +1,45 @@
+/**
+ * @file vars.h
+ * @author Bonino, Francisco Ignacio (franbonino82@gmail.com).
+ * @brief Header de librería con la tabla de variables
+ *        de la shell.
+ * @version 1.0
+ * @since 2026-10-17
+ */
+
+#ifndef __VARS__
+#define __VARS__
+
+/* ---------- Librerías a utilizar -------------- */
+
+#include "utilities.h"
+
+/* ---------- Definición de constantes ---------- */
+
+#define _VARS_INIT_SIZE_ 64 // Debe ser una potencia de 2
+
+/* ---------- Definición de tipos --------------- */
+
+typedef struct var_entry
+{
+    char *name;
+    char *value; // Valor de la variable, o NULL si se eliminó
+} var_entry;
+
+/* ---------- Declaración de variables ---------- */
+
+var_entry *vars_table;
+
+size_t vars_size, vars_used;
+
+/* ---------- Prototipado de funciones ---------- */
+
+void var_export(char *, char *);
+void var_set(char *, char *);
+void var_unset(char *);
+
+char *var_get(char *);
+
+bool is_var_name(char *, size_t);
+
+#endif
@@ -6,7 +6,7 @@
  * @since 2021-10-04
  */
 
-#include "include/headers/shell_cmds.h"
+#include "include/headers/batch.h"
 
 /**
  * @brief Función principal de la shell.
@@ -17,16 +17,33 @@
  *          haber recibido dicho comando, se ejecuta lo que
  *          corresponda y se vuelve a pedir un input al
  *          usuario para evaluar y ejecutar.
+ *          El EOF en la entrada (Ctrl+D) también cierra la shell.
  *          Si el programa se ejecuta con un argumento ARG,
  *          se buscará en el directorio 'bfs/' un archivo
  *          batchfile llamado ARG.sh desde el cual se tomarán
- *          los comandos a ejecutar. Cuando se detecta el EOF,
- *          o la instrucción 'quit', la shell se cierra.
+ *          los comandos a ejecutar (si ARG contiene '/', se lo
+ *          toma directamente como el path del script). Con la
+ *          opción '-c CMD' se ejecutan los comandos de CMD, y
+ *          si stdin no es una terminal, se leen de allí.
+ *          Cuando se detecta el EOF, o la instrucción 'quit',
+ *          la shell se cierra.
+ *          Por defecto, el batchfile se ejecuta lo más rápido
+ *          posible y sin mostrar prompt ni las líneas leídas,
+ *          a partir de su versión compilada (ver batch_script).
+ *          Con la opción '-t' (o '--trace') antes de ARG, se
+ *          muestra cada línea con el prompt y se hace una pausa
+ *          antes de ejecutarla.
+ *          Fuera del modo interactivo no se muestran mensajes
+ *          de bienvenida ni de despedida, y las líneas pueden
+ *          ejecutarse en paralelo con la opción '-j N' o dentro
+ *          de bloques 'parallel { ... }' (ver batch_line).
+ *          Con la opción '-p N' se elige la capacidad de los
+ *          pipes que crea la shell (ver 'set pipesize').
  *
  * @param argc Cantidad de argumentos recibidos.
  * @param argv Vector con los argumentos recibidos.
  *
- * @returns Si la ejecución del programa fue exitosa.
+ * @returns El código de salida del último comando ejecutado.
  */
 int main(int argc, char **argv)
 {
@@ -35,23 +52,23 @@ int main(int argc, char **argv)
     if (!base_cwd)
         show_err("Could not get the base cwd", _FATAL_ERR_);
 
-    if ((regcomp(&bg_regex, "[ \t]*&[ \t]*$", 0) != 0) ||
-        (regcomp(&cd_regex, "^[ \t]*cd[ \t]*", 0) != 0) ||
-        (regcomp(&clr_regex, "^[ \t]*clr[ \t]*$", 0) != 0) ||
-        (regcomp(&echo_regex, "^[ \t]*echo[ \t]*", 0) != 0) ||
-        (regcomp(&pipe_regex, "[ \t]*[|][ \t]*", 0) != 0) ||
-        (regcomp(&quit_regex, "^[ \t]*quit[ \t]*$", 0) != 0))
-        show_err("Could not compile regex", _FATAL_ERR_);
+    cwd_update();
 
     char group_name[_HOST_MAX_LEN_];
 
-    char *prompt;
-    char *user_name;
+    char *user_name = NULL;
+    char *cmd_str = NULL;
+    char *bf_path = NULL;
 
     bool bf = false;
+    bool interactive;
     bool quit = false;
+    bool trace = false;
 
-    FILE *input_file = NULL;
+    int arg = 1;
+    int bf_fd = -1;
+
+    launch_mode = _LAUNCH_SPAWN_;
 
     /*
         Ignoramos en el proceso padre las señales especificadas.
@@ -63,17 +80,60 @@ int main(int argc, char **argv)
         signal(SIGQUIT, SIG_IGN) == SIG_ERR)
         show_err("Could not ignore signals in parent process", _FATAL_ERR_);
 
-    if (argc > 2)
+    jobs_init();
+
+    /*
+        Opciones para ejecutar el batchfile en modo demostración ('-t'),
+        con hasta N líneas en paralelo ('-j N') o con pipes de una
+        capacidad dada ('-p N', como 'set pipesize').
+    */
+    while (arg < argc)
+    {
+        if ((strcmp(argv[arg], "-t") == 0) || (strcmp(argv[arg], "--trace") == 0))
+        {
+            trace = true;
+
+            arg++;
+        }
+        else if (((strcmp(argv[arg], "-j") == 0) || (strcmp(argv[arg], "-p") == 0)) && (arg + 1 == argc))
+            show_err((argv[arg][1] == 'j') ? "Missing value for -j" : "Missing value for -p", _FATAL_ERR_);
+        else if (strcmp(argv[arg], "-j") == 0)
+        {
+            char *end;
+
+            long value = strtol(argv[arg + 1], &end, 10);
+
+            if ((*end != '\0') || (value < 1) || (value > INT_MAX))
+                show_err("Invalid parallel jobs amount", _FATAL_ERR_);
+
+            batch_width = (int)value;
+
+            arg += 2;
+        }
+        else if (strcmp(argv[arg], "-p") == 0)
+        {
+            if ((pipe_size = pipe_size_parse(argv[arg + 1])) == -1)
+                show_err("Invalid pipe size", _FATAL_ERR_);
+
+            arg += 2;
+        }
+        else
+            break;
+    }
+
+    if ((argc == arg + 2) && !trace && (strcmp(argv[arg], "-c") == 0))
+        cmd_str = argv[arg + 1]; // Comandos a ejecutar recibidos como argumento
+    else if ((argc > arg + 1) || (strcmp(argv[argc - 1], "-c") == 0))
         show_err("Invalid program arguments amount", _FATAL_ERR_);
-    else if (argc == 2)
+    else if (argc == arg + 1)
     {
-        if ((strcmp(argv[1], "-h") == 0) || (strcmp(argv[1], "?") == 0) || (strcmp(argv[1], "--help") == 0))
+        if ((strcmp(argv[arg], "-h") == 0) || (strcmp(argv[arg], "?") == 0) || (strcmp(argv[arg], "--help") == 0))
         {
             show_help(_HELP_);
 
             return EXIT_SUCCESS;
         }
-        else if (strcmp(argv[1], "-e") == 0)
+        else if (strcmp(argv[arg], "-e") == 0)
         {
             show_help(_EXPS_);
 
@@ -82,77 +142,103 @@ int main(int argc, char **argv)
         else
         {
             // + 4 por "bfs/" y + 3 por ".sh"
-            char *bf_path = (char *)malloc(strlen(argv[1]) + sizeof(NULL) + (sizeof(char) * 7));
+            bf_path = (char *)malloc(strlen(argv[arg]) + sizeof(NULL) + (sizeof(char) * 7));
 
             if (!bf_path)
                 show_err("Could not allocate memory for batchfile directory", _FATAL_ERR_);
 
-            strcpy(bf_path, "bfs/");
+            // Un script con '/' puede estar en cualquier ubicación
+            if (strchr(argv[arg], '/'))
+                strcpy(bf_path, argv[arg]);
+            else
+            {
+                strcpy(bf_path, "bfs/");
 
-            strcat(bf_path, argv[1]);
-            strcat(bf_path, ".sh");
+                strcat(bf_path, argv[arg]);
+                strcat(bf_path, ".sh");
+            }
 
-            if (open_file_r(&input_file, bf_path))
-                bf = true;
+            bf_fd = open(bf_path, (O_RDONLY | O_CLOEXEC));
+        }
 
-            free(bf_path);
+        if (bf_fd == -1)
+            show_err(strerror(errno), _FATAL_ERR_);
 
-            if (!bf)
-                show_err(strerror(errno), _FATAL_ERR_);
-        }
+        bf = true;
     }
 
-    if (gethostname(group_name, _HOST_MAX_LEN_) != 0)
-        show_err("Could not get hostname", _FATAL_ERR_);
-
-    user_name = getenv("USER");
+    /*
+        Sólo es interactiva la shell que lee sus comandos de una terminal.
+        Si los comandos vienen de un batchfile, de '-c' o de un pipe, no
+        se muestran mensajes ni prompts (salvo en modo demostración), y
+        ni siquiera se arman los datos del prompt.
+    */
+    interactive = !bf && !cmd_str && isatty(STDIN_FILENO);
 
-    if (!user_name)
-        show_err("Could not get username", _FATAL_ERR_);
+    if (interactive && batch_width)
+        show_err("Parallel execution is only available for batchfiles, -c or piped commands", _FATAL_ERR_);
 
-    prompt = (char *)malloc(strlen(user_name) + strlen(group_name) +
-                           (strlen(_FG_COLOR_YELLOW_) * 3) + (strlen(_FG_COLOR_GREEN_) * 2) +
-                            strlen(_FG_COLOR_BLUE_) + strlen(_FORMAT_RESET_ALL_) + sizeof(NULL));
+    if (interactive || trace)
+    {
+        if (gethostname(group_name, _HOST_MAX_LEN_) != 0)
+            show_err("Could not get hostname", _FATAL_ERR_);
 
-    if (!prompt)
-        show_err("Could not allocate memory for prompt", _FATAL_ERR_);
+        user_name = getenv("USER");
 
-    print_hmsg(_WELC_);
+        if (!user_name)
+            show_err("Could not get username", _FATAL_ERR_);
 
-    memset(input, 0, sizeof(input)); // Para evitar basura en el input del usuario
+        print_hmsg(_WELC_);
+    }
 
-    if (!bf) // Análisis del input del usuario
-        while (!quit)
+    if (cmd_str) // Comandos recibidos con '-c', una línea a la vez
+    {
+        for (char *next = cmd_str; next && !quit; )
         {
-            mk_prompt(user_name, group_name, &prompt);
+            char *line = next;
 
-            if (write(STDOUT_FILENO, prompt, strlen(prompt)) == -1)
-            {
-                fprintf(stderr, "\nFatal error on write instruction --- ABORTING\n");
+            if ((next = strchr(line, '\n')))
+                *next++ = '\0';
 
-                free(prompt);
+            line = strtrim(line);
 
-                exit(EXIT_FAILURE);
-            }
+            if (!stremp(line))
+                quit = batch_line(line);
+        }
 
-            if (read(STDIN_FILENO, input, _STR_MAX_LEN_) == -1)
-                show_err("Could not get user input", _FATAL_ERR_);
+        batch_end();
+    }
+    else if (bf && !trace && batch_script(bf_path, bf_fd)) // Batchfile compilado
+        close(bf_fd);
+    else
+    {
+        /*
+            Tanto el input del usuario como el batchfile se leen con un
+            lector de líneas, que devuelve todas las líneas completas de
+            cada lectura y conserva las incompletas para la siguiente.
+        */
+        line_reader reader;
 
-            strcpy(input, chop_to_char(strtrim(input), "\n"));
+        size_t len;
 
-            // Sólo ejecutamos líneas de código no vacías
-            if (!stremp(input))
-                quit = read_line(input);
+        char *line;
 
-            memset(input, 0, sizeof(input)); // Reseteamos el input
-        }
-    else // Análisis de batchfile
-        while (!quit && (fgets(input, _STR_MAX_LEN_, input_file) != NULL))
+        reader_init(&reader, bf ? bf_fd : STDIN_FILENO);
+
+        while (!quit)
         {
-            mk_prompt(user_name, group_name, &prompt);
+            if (interactive || trace)
+            {
+                if (interactive)
+                    jobs_notify();
 
-            if ((write(STDOUT_FILENO, prompt, strlen(prompt)) == -1) ||
-                (write(STDOUT_FILENO, input, strlen(input)) == -1))
+                mk_prompt(user_name, group_name);
+
+                out_flush();
+            }
+
+            // En modo interactivo se muestra el prompt antes de leer la línea
+            if (interactive && (write(STDOUT_FILENO, prompt, prompt_len) == -1))
             {
                 fprintf(stderr, "\nFatal error on write instruction --- ABORTING\n");
 
@@ -161,10 +247,28 @@ int main(int argc, char **argv)
                 exit(EXIT_FAILURE);
             }
 
-            sleep(1); // Pausa para ver qué input se va a analizar
+            uint64_t start = stat_now();
+
+            line = reader_next(&reader, &len);
 
-            if (!strstr(input, "\n"))
-                if (write(STDOUT_FILENO, "\n", 2) == -1)
+            // En modo interactivo, la lectura incluye lo que tarda el usuario en escribir
+            if (!interactive)
+                stat_phase(_PH_READ_, start);
+
+            if (!line)
+            {
+                // EOF (Ctrl+D): se cierra la shell como con 'quit'
+                if (interactive)
+                    out_write("\n");
+
+                break;
+            }
+
+            if (trace)
+            {
+                if ((write(STDOUT_FILENO, prompt, prompt_len) == -1) ||
+                    (write(STDOUT_FILENO, line, len) == -1) ||
+                    (write(STDOUT_FILENO, "\n", 1) == -1))
                 {
                     fprintf(stderr, "\nFatal error on write instruction --- ABORTING\n");
 
@@ -173,17 +277,36 @@ int main(int argc, char **argv)
                     exit(EXIT_FAILURE);
                 }
 
-            strcpy(input, chop_to_char(strtrim(input), "\n"));
+                sleep(1); // Pausa para ver qué input se va a analizar
+            }
 
-            if (!stremp(input))
-                quit = read_line(input);
+            line = strtrim(line);
 
-            memset(input, 0, sizeof(input));
+            // Sólo ejecutamos líneas de código no vacías
+            if (!stremp(line))
+                quit = interactive ? ctl_line(line) : batch_line(line);
         }
 
-    print_hmsg(_FARE_);
+        if (interactive)
+            ctl_end();
+        else
+            batch_end();
+
+        reader_free(&reader);
+
+        if (bf)
+            close(bf_fd);
+    }
+
+    out_flush();
+
+    if (interactive || trace)
+        print_hmsg(_FARE_);
 
     free(prompt);
+    free(bf_path);
+
+    arena_free(&cmd_arena);
 
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+    return last_status; // Código de salida del último comando ejecutado
+}